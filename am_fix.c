@@ -28,6 +28,7 @@
 #include "external/printf/printf.h"
 #include "frequencies.h"
 #include "functions.h"
+#include "helper/rssi.h"
 #include "misc.h"
 #include "settings.h"
 #ifdef ENABLE_AGC_SHOW_DATA
@@ -288,7 +289,7 @@ void AM_fix_10ms(const unsigned vfo)
 	int16_t rssi;
 	{	// sample the current RSSI level
 		// average it with the previous rssi (a bit of noise/spike immunity)
-		const int16_t new_rssi = BK4819_GetRSSI();
+		const int16_t new_rssi = RSSI_Get()->Rssi;
 		rssi                   = (prev_rssi[vfo] > 0) ? (prev_rssi[vfo] + new_rssi) / 2 : new_rssi;
 		prev_rssi[vfo]         = new_rssi;
 	}
@@ -362,6 +363,7 @@ void AM_fix_10ms(const unsigned vfo)
 		gain_table_index_prev[vfo] = index;
 		currentGainDiff = gain_table[0].gain_dB - gain_table[index].gain_dB;
 		BK4819_WriteRegister(BK4819_REG_13, gain_table[index].reg_val);
+		RSSI_Invalidate();
 #ifdef ENABLE_AGC_SHOW_DATA
 		UI_MAIN_PrintAGC(true);
 #endif
@@ -20,6 +20,9 @@
 #include "app/action.h"
 #include "app/app.h"
 #include "app/chFrScanner.h"
+#ifdef ENABLE_CHANNEL_STATS
+	#include "app/chstats.h"
+#endif
 #include "app/common.h"
 #include "app/dtmf.h"
 #ifdef ENABLE_FLASHLIGHT
@@ -110,6 +113,12 @@ void (*action_opt_table[])(void) = {
 #else
 	[ACTION_OPT_SPECTRUM] = &FUNCTION_NOP,
 #endif
+
+#ifdef ENABLE_CHANNEL_STATS
+	[ACTION_OPT_CHSTATS] = &CHSTATS_Show,
+#else
+	[ACTION_OPT_CHSTATS] = &FUNCTION_NOP,
+#endif
 };
 
 static_assert(ARRAY_SIZE(action_opt_table) == ACTION_OPT_LEN);
@@ -190,8 +199,7 @@ void ACTION_Scan(bool bRestart)
 #ifdef ENABLE_DTMF_CALLING
 	DTMF_clear_RX();
 #endif
-	gDTMF_RX_live_timeout = 0;
-	memset(gDTMF_RX_live, 0, sizeof(gDTMF_RX_live));
+	DTMF_clear_RX_live();
 
 	RADIO_SelectVfos();
 
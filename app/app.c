@@ -26,6 +26,9 @@
 #endif
 #include "app/app.h"
 #include "app/chFrScanner.h"
+#ifdef ENABLE_CHANNEL_STATS
+	#include "app/chstats.h"
+#endif
 #include "app/dtmf.h"
 #ifdef ENABLE_FLASHLIGHT
 	#include "app/flashlight.h"
@@ -58,6 +61,14 @@
 #include "frequencies.h"
 #include "functions.h"
 #include "helper/battery.h"
+#ifdef ENABLE_PROFILING
+	#include "helper/profile.h"
+#endif
+#include "helper/rssi.h"
+#ifdef ENABLE_RSSI_TRACE
+	#include "helper/rssi_trace.h"
+#endif
+#include "helper/task.h"
 #include "misc.h"
 #include "radio.h"
 #include "settings.h"
@@ -77,6 +88,7 @@ static bool flagSaveSettings;
 static bool flagSaveChannel;
 
 static void ProcessKey(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld);
+static void ProcessKeyEvents(void);
 
 
 void (*ProcessKeysFunctions[])(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld) = {
@@ -91,6 +103,10 @@ void (*ProcessKeysFunctions[])(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
 #ifdef ENABLE_AIRCOPY
 	[DISPLAY_AIRCOPY] = &AIRCOPY_ProcessKeys,
 #endif
+
+#ifdef ENABLE_CHANNEL_STATS
+	[DISPLAY_CHSTATS] = &CHSTATS_ProcessKeys,
+#endif
 };
 
 static_assert(ARRAY_SIZE(ProcessKeysFunctions) == DISPLAY_N_ELEM);
@@ -174,7 +190,7 @@ static void HandleIncoming(void)
 {
 	if (!g_SquelchLost) {	// squelch is closed
 #ifdef ENABLE_DTMF_CALLING
-		if (gDTMF_RX_index > 0)
+		if (gDTMF_RX.Count > 0)
 			DTMF_clear_RX();
 #endif
 		if (gCurrentFunction != FUNCTION_FOREGROUND) {
@@ -241,6 +257,10 @@ static void HandleReceive(void)
 
 	uint8_t Mode = END_OF_RX_MODE_SKIP;
 
+#ifdef ENABLE_CHANNEL_STATS
+	CHSTATS_SampleRssi(RSSI_Get()->Rssi);
+#endif
+
 	if (gFlagTailToneEliminationComplete) {
 		Mode = END_OF_RX_MODE_END;
 		goto Skip;
@@ -440,6 +460,12 @@ void APP_StartListening(FUNCTION_Type_t function)
 	if (gScanStateDir != SCAN_OFF)
 		CHFRSCANNER_Found();
 
+#ifdef ENABLE_CHANNEL_STATS
+	// scanner stops and plain receptions alike, the monitor isn't a signal
+	if (function == FUNCTION_RECEIVE)
+		CHSTATS_Open(gRxVfo->CHANNEL_SAVE);
+#endif
+
 #ifdef ENABLE_NOAA
 	if (IS_NOAA_CHANNEL(gRxVfo->CHANNEL_SAVE) && gIsNoaaMode) {
 		gRxVfo->CHANNEL_SAVE        = gNoaaChannel + NOAA_CHANNEL_FIRST;
@@ -558,16 +584,41 @@ static void DualwatchAlternate(void)
 	#endif
 }
 
+#ifdef ENABLE_VOX
+static void HandleVox(void);
+
+#ifdef ENABLE_PROFILING
+static uint32_t gVoxEdge_us;
+#endif
+
+// key up as soon as the voice has been held for vox_key_up_delay_10ms,
+// straight from the tick that ends the delay
+static void VOX_CheckKeyUp(void)
+{
+#ifdef ENABLE_FMRADIO
+	// no key up while the FM radio is waiting to be restored
+	if (gFmRadioMode && gFM_RestoreCountdown_10ms > 0)
+		return;
+#endif
+
+	if (gEeprom.VOX_SWITCH && g_VOX_Lost && gVoxPauseCountdown == 0 &&
+	    gCurrentFunction != FUNCTION_TRANSMIT && !AUDIO_IsTonePlaying())
+	{
+		HandleVox();
+	}
+}
+#endif
+
 static void CheckRadioInterrupts(void)
 {
 	if (SCANNER_IsScanning())
 		return;
 
-	while (BK4819_ReadRegister(BK4819_REG_0C) & 1u) { // BK chip interrupt request
-		// clear interrupts
-		BK4819_WriteRegister(BK4819_REG_02, 0);
-		// fetch interrupt status bits
+	// latch whatever the chip has pending, then handle only what was latched
+	BK4819_PollEvents();
 
+	BK4819_Event_t event;
+	while (BK4819_GetEvent(&event)) {
 		union {
 			struct {
 				uint16_t __UNUSED : 1;
@@ -590,7 +641,7 @@ static void CheckRadioInterrupts(void)
 			uint16_t __raw;
 		} interrupts;
 
-		interrupts.__raw = BK4819_ReadRegister(BK4819_REG_02);
+		interrupts.__raw = event.Status;
 
 		// 0 = no phase shift
 		// 1 = 120deg phase shift
@@ -601,35 +652,18 @@ static void CheckRadioInterrupts(void)
 //			g_CTCSS_Lost = true;
 
 		if (interrupts.dtmf5ToneFound) {	
-			const char c = DTMF_GetCharacter(BK4819_GetDTMF_5TONE_Code()); // save the RX'ed DTMF character
+			const char c = DTMF_GetCharacter(event.Dtmf); // save the RX'ed DTMF character
 			if (c != 0xff) {
 				if (gCurrentFunction != FUNCTION_TRANSMIT) {
 					if (gSetting_live_DTMF_decoder) {
-						size_t len = strlen(gDTMF_RX_live);
-						if (len >= sizeof(gDTMF_RX_live) - 1) { // make room
-							memmove(&gDTMF_RX_live[0], &gDTMF_RX_live[1], sizeof(gDTMF_RX_live) - 1);
-							len--;
-						}
-						gDTMF_RX_live[len++]  = c;
-						gDTMF_RX_live[len]    = 0;
+						DTMF_RingPush(&gDTMF_RX_live, c);
 						gDTMF_RX_live_timeout = DTMF_RX_live_timeout_500ms;  // time till we delete it
 						gUpdateDisplay        = true;
 					}
 
 #ifdef ENABLE_DTMF_CALLING
-					if (gRxVfo->DTMF_DECODING_ENABLE || gSetting_KILLED) {
-						if (gDTMF_RX_index >= sizeof(gDTMF_RX) - 1) { // make room
-							memmove(&gDTMF_RX[0], &gDTMF_RX[1], sizeof(gDTMF_RX) - 1);
-							gDTMF_RX_index--;
-						}
-						gDTMF_RX[gDTMF_RX_index++] = c;
-						gDTMF_RX[gDTMF_RX_index]   = 0;
-						gDTMF_RX_timeout           = DTMF_RX_timeout_500ms;  // time till we delete it
-						gDTMF_RX_pending           = true;
-						
-						SYSTEM_DelayMs(3);//fix DTMF not reply@Yurisu
-						DTMF_HandleRequest();
-					}
+					if (gRxVfo->DTMF_DECODING_ENABLE || gSetting_KILLED)
+						DTMF_RX_Append(c);  // matched here, acted on once the events are drained
 #endif
 				}
 			}
@@ -640,7 +674,7 @@ static void CheckRadioInterrupts(void)
 
 		if (interrupts.cdcssLost) {
 			g_CDCSS_Lost = true;
-			gCDCSSCodeType = BK4819_GetCDCSSCodeType();
+			gCDCSSCodeType = (event.Reg0C >> 14) & 3u;
 		}
 
 		if (interrupts.cdcssFound)
@@ -655,7 +689,11 @@ static void CheckRadioInterrupts(void)
 #ifdef ENABLE_VOX
 		if (interrupts.voxLost) {
 			g_VOX_Lost         = true;
-			gVoxPauseCountdown = 10;
+			gVoxPauseCountdown = vox_key_up_delay_10ms;
+
+#ifdef ENABLE_PROFILING
+			gVoxEdge_us = PROFILE_GetTimeUs();
+#endif
 
 			if (gEeprom.VOX_SWITCH) {
 				if (gCurrentFunction == FUNCTION_POWER_SAVE && !gRxIdleMode) {
@@ -696,14 +734,18 @@ static void CheckRadioInterrupts(void)
 			gAircopyState == AIRCOPY_TRANSFER &&
 			gAirCopyIsSendMode == 0)
 		{
-			for (unsigned int i = 0; i < 4; i++) {
-				g_FSK_Buffer[gFSKWriteIndex++] = BK4819_ReadRegister(BK4819_REG_5F);
+			for (unsigned int i = 0; i < ARRAY_SIZE(event.Fifo); i++) {
+				g_FSK_Buffer[gFSKWriteIndex++] = event.Fifo[i];
 			}
 
 			AIRCOPY_StorePacket();
 		}
 #endif
 	}
+
+#ifdef ENABLE_DTMF_CALLING
+	DTMF_HandleRequest();
+#endif
 }
 
 void APP_EndTransmission(void)
@@ -719,6 +761,16 @@ void APP_EndTransmission(void)
 	}
 }
 
+void APP_ReturnToRX(void)
+{	// once the roger is out, or after the repeater tail tone elimination time
+	if (gEeprom.REPEATER_TAIL_TONE_ELIMINATION > 0)
+		gRTTECountdown_10ms = gEeprom.REPEATER_TAIL_TONE_ELIMINATION * 10;
+	else if (AUDIO_IsTonePlaying())
+		gRTTECountdown_10ms = 1;
+	else
+		FUNCTION_Select(FUNCTION_FOREGROUND);
+}
+
 #ifdef ENABLE_VOX
 static void HandleVox(void)
 {
@@ -760,13 +812,7 @@ static void HandleVox(void)
 			}
 			else {
 				APP_EndTransmission();
-
-				if (gEeprom.REPEATER_TAIL_TONE_ELIMINATION == 0) {
-					//if (gCurrentFunction != FUNCTION_FOREGROUND)
-						FUNCTION_Select(FUNCTION_FOREGROUND);
-				}
-				else
-					gRTTECountdown_10ms = gEeprom.REPEATER_TAIL_TONE_ELIMINATION * 10;
+				APP_ReturnToRX();
 			}
 
 			gUpdateStatus        = true;
@@ -788,6 +834,11 @@ static void HandleVox(void)
 #endif
 			RADIO_PrepareTX();
 			gUpdateDisplay = true;
+
+#ifdef ENABLE_PROFILING
+			if (gCurrentFunction == FUNCTION_TRANSMIT)
+				gProfileCounters[PROFILE_VOX_TO_TX_US] = PROFILE_GetTimeUs() - gVoxEdge_us;
+#endif
 		}
 	}
 }
@@ -818,6 +869,12 @@ void APP_Update(void)
 	if (gReducedService)
 		return;
 
+	ProcessKeyEvents();
+
+	// a beep or the roger owns the BK4819, the radio side waits for it
+	if (AUDIO_IsTonePlaying())
+		return;
+
 	if (gCurrentFunction != FUNCTION_TRANSMIT)
 		HandleFunction();
 
@@ -881,7 +938,8 @@ void APP_Update(void)
 	}
 
 #ifdef ENABLE_FMRADIO
-	if (gScheduleFM && gFM_ScanState != FM_SCAN_OFF && !FUNCTION_IsRx()) {
+	// the lock check reads the BK1080, hold it off until the chip has powered up
+	if (gScheduleFM && gFM_ScanState != FM_SCAN_OFF && !FUNCTION_IsRx() && BK1080_IsReady()) {
 		// switch to FM radio mode
 		FM_Play();
 		gScheduleFM = false;
@@ -944,14 +1002,14 @@ void APP_Update(void)
 
 			FUNCTION_Init();
 
-			gPowerSave_10ms = power_save1_10ms; // come back here in a bit
+			gPowerSave_10ms = power_save_rx_10ms[gEeprom.BATTERY_SAVE]; // come back here in a bit
 			gRxIdleMode     = false;            // RX is awake
 		}
 		else if (gEeprom.DUAL_WATCH == DUAL_WATCH_OFF || gScanStateDir != SCAN_OFF || gCssBackgroundScan || goToSleep)
 		{	// dual watch mode off or scanning or rssi update request
 			// go back to sleep
 
-			gPowerSave_10ms = gEeprom.BATTERY_SAVE * 10;
+			gPowerSave_10ms = power_save_sleep_10ms[gEeprom.BATTERY_SAVE];
 			gRxIdleMode     = true;
 			goToSleep = false;
 
@@ -973,6 +1031,49 @@ void APP_Update(void)
 	}
 }
 
+#ifdef ENABLE_PROFILING
+static uint32_t gPttEdge_us;
+static uint32_t gKeyEdge_us;
+#endif
+
+static void QueueKeyEvent(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
+{
+	const KEYBOARD_Event_t Event = {
+		.Key         = Key,
+		.bKeyPressed = bKeyPressed,
+		.bKeyHeld    = bKeyHeld,
+#ifdef ENABLE_PROFILING
+		.Edge_us     = (Key == KEY_PTT) ? gPttEdge_us : gKeyEdge_us,
+#endif
+	};
+
+	KEYBOARD_PushEvent(&Event);
+}
+
+// debounced in the 10ms slice, acted on from APP_Update as soon as it returns
+static void ProcessKeyEvents(void)
+{
+	KEYBOARD_Event_t Event;
+
+	while (KEYBOARD_PopEvent(&Event)) {
+		ProcessKey(Event.Key, Event.bKeyPressed, Event.bKeyHeld);
+
+		if (Event.Key == KEY_PTT && !Event.bKeyPressed && gKeyReading1 != KEY_INVALID)
+			gPttWasReleased = true;
+
+#ifdef ENABLE_PROFILING
+		if (Event.bKeyPressed && !Event.bKeyHeld) {
+			const uint32_t latency_us = PROFILE_GetTimeUs() - Event.Edge_us;
+
+			if (Event.Key != KEY_PTT)
+				gProfileCounters[PROFILE_KEY_TO_ACTION_US] = latency_us;
+			else if (gCurrentFunction == FUNCTION_TRANSMIT)
+				gProfileCounters[PROFILE_PTT_TO_TX_US] = latency_us;
+		}
+#endif
+	}
+}
+
 // called every 10ms
 static void CheckKeys(void)
 {
@@ -995,10 +1096,8 @@ static void CheckKeys(void)
 		{	// PTT released or serial comms config in progress
 			if (++gPttDebounceCounter >= 3 || SerialConfigInProgress())	    // 30ms
 			{	// stop transmitting
-				ProcessKey(KEY_PTT, false, false);
+				QueueKeyEvent(KEY_PTT, false, false);
 				gPttIsPressed = false;
-				if (gKeyReading1 != KEY_INVALID)
-					gPttWasReleased = true;
 			}
 		}
 		else
@@ -1006,12 +1105,16 @@ static void CheckKeys(void)
 	}
 	else if (!GPIO_CheckBit(&GPIOC->DATA, GPIOC_PIN_PTT) && !SerialConfigInProgress())
 	{	// PTT pressed
+#ifdef ENABLE_PROFILING
+		if (gPttDebounceCounter == 0)
+			gPttEdge_us = PROFILE_GetTimeUs();
+#endif
 		if (++gPttDebounceCounter >= 3)	    // 30ms
 		{	// start transmitting
 			boot_counter_10ms   = 0;
 			gPttDebounceCounter = 0;
 			gPttIsPressed       = true;
-			ProcessKey(KEY_PTT, true, false);
+			QueueKeyEvent(KEY_PTT, true, false);
 		}
 	}
 	else
@@ -1019,8 +1122,10 @@ static void CheckKeys(void)
 
 // --------------------- OTHER KEYS ----------------------------
 
-	// scan the hardware keys
-	KEY_Code_t Key = KEYBOARD_Poll();
+	// scan the hardware keys, the full matrix only once something is down
+	KEY_Code_t Key = KEY_INVALID;
+	if (gKeyReading0 != KEY_INVALID || KEYBOARD_IsAnyKeyPressed())
+		Key = KEYBOARD_Poll();
 
 	if (Key != KEY_INVALID) // any key pressed
 		boot_counter_10ms = 0;   // cancel boot screen/beeps if any key pressed
@@ -1029,10 +1134,13 @@ static void CheckKeys(void)
 	{
 
 		if (gKeyReading0 != KEY_INVALID && Key != KEY_INVALID)
-			ProcessKey(gKeyReading1, false, gKeyBeingHeld);  // key pressed without releasing previous key
+			QueueKeyEvent(gKeyReading1, false, gKeyBeingHeld);  // key pressed without releasing previous key
 
 		gKeyReading0     = Key;
 		gDebounceCounter = 0;
+#ifdef ENABLE_PROFILING
+		gKeyEdge_us      = PROFILE_GetTimeUs();
+#endif
 		return;
 	}
 
@@ -1044,14 +1152,14 @@ static void CheckKeys(void)
 		{
 			if (gKeyReading1 != KEY_INVALID) // some button was pressed before
 			{
-				ProcessKey(gKeyReading1, false, gKeyBeingHeld); // process last button released event
+				QueueKeyEvent(gKeyReading1, false, gKeyBeingHeld); // process last button released event
 				gKeyReading1 = KEY_INVALID;
 			}
 		}
 		else // process new key pressed
 		{
 			gKeyReading1 = Key;
-			ProcessKey(Key, true, false);
+			QueueKeyEvent(Key, true, false);
 		}
 
 		gKeyBeingHeld = false;
@@ -1066,7 +1174,7 @@ static void CheckKeys(void)
 		if (Key != KEY_PTT)
 		{
 			gKeyBeingHeld = true;
-			ProcessKey(Key, true, true); // key held event
+			QueueKeyEvent(Key, true, true); // key held event
 		}
 	}
 	else //subsequent fast key repeats
@@ -1075,7 +1183,7 @@ static void CheckKeys(void)
 		{
 			gKeyBeingHeld = true;
 			if ((gDebounceCounter % key_repeat_10ms) == 0)
-				ProcessKey(Key, true, true); // key held event
+				QueueKeyEvent(Key, true, true); // key held event
 		}
 
 		if (gDebounceCounter < 0xFFFF)
@@ -1085,17 +1193,106 @@ static void CheckKeys(void)
 	}
 }
 
+#ifdef ENABLE_ALARM
+// the TX alarm drops to the site alarm, after the tail tone when there is one
+static void ALARM_StopTx(void)
+{
+	BK4819_SetupPowerAmplifier(0, 0);
+	BK4819_ToggleGpioOut(BK4819_GPIO1_PIN29_PA_ENABLE, false);
+	BK4819_Enable_AfDac_DiscMode_TxDsp();
+	BK4819_ToggleGpioOut(BK4819_GPIO5_PIN1_RED, false);
+
+	GUI_DisplayScreen();
+}
+#endif
+
+#ifdef ENABLE_CSS_DECODE
+// read back the CxCSS detectors while a carrier squelch channel is open,
+// nothing is retuned so the audio carries on
+static void HandleCssDecode(void)
+{
+	static uint8_t        pollCountdown;
+	static DCS_CodeType_t lastType;
+	static uint8_t        lastCode;
+
+	if (gCurrentFunction != FUNCTION_RECEIVE ||
+	    gCurrentCodeType != CODE_TYPE_OFF ||
+	    gRxVfo->Modulation != MODULATION_FM ||
+	    SCANNER_IsScanning())
+	{
+		pollCountdown = 0;
+		lastType      = CODE_TYPE_OFF;
+		return;
+	}
+
+	if (pollCountdown > 0) {
+		pollCountdown--;
+		return;
+	}
+
+	pollCountdown = css_decode_poll_10ms - 1;
+
+	uint32_t cdcssFreq;
+	uint16_t ctcssFreq;
+	DCS_CodeType_t Type = CODE_TYPE_OFF;
+	uint8_t        Code = 0xFF;
+
+	switch (BK4819_GetCxCSSScanResult(&cdcssFreq, &ctcssFreq)) {
+		case BK4819_CSS_RESULT_CDCSS:
+			Type = CODE_TYPE_DIGITAL;
+			Code = DCS_GetCdcssCode(cdcssFreq);
+			if (Code == 0xFF) {
+				Type = CODE_TYPE_REVERSE_DIGITAL;
+				Code = DCS_GetCdcssCode(cdcssFreq ^ 0x7FFFFF);
+			}
+			// REG_51 is left in the carrier squelch CTCSS setup, the DCS
+			// readback may hold a stale word there, the tone gets its turn
+			if (Code != 0xFF || !BK4819_GetCTCSSScanResult(&ctcssFreq))
+				break;
+			[[fallthrough]];
+		case BK4819_CSS_RESULT_CTCSS:
+			Type = CODE_TYPE_CONTINUOUS_TONE;
+			Code = DCS_GetCtcssCode(ctcssFreq);
+			break;
+		default:
+			break;
+	}
+
+	if (Code == 0xFF)
+		Type = CODE_TYPE_OFF;
+
+	// the same result twice in a row before it goes on screen
+	if (Type != CODE_TYPE_OFF && Type == lastType && Code == lastCode &&
+	    (Type != gRxCssDecodeType || Code != gRxCssDecodeCode))
+	{
+		gRxCssDecodeType = Type;
+		gRxCssDecodeCode = Code;
+		gUpdateDisplay   = true;
+	}
+
+	lastType = Type;
+	lastCode = Code;
+}
+#endif
+
 void APP_TimeSlice10ms(void)
 {
 	gNextTimeslice = false;
 	gFlashLightBlinkCounter++;
 
+	AUDIO_ToneTick();
+	TASK_Run();
+
 #ifdef ENABLE_BOOT_BEEPS
 	if (boot_counter_10ms > 0 && (boot_counter_10ms % 25) == 0) {
 		AUDIO_PlayBeep(BEEP_880HZ_40MS_OPTIONAL);
 	}
 #endif
 
+#ifdef ENABLE_RSSI_TRACE
+	RSSI_TRACE_TimeSlice10ms();
+#endif
+
 #ifdef ENABLE_AM_FIX
 	if (gRxVfo->Modulation == MODULATION_AM) {
 		AM_fix_10ms(gEeprom.RX_VFO);
@@ -1113,9 +1310,15 @@ void APP_TimeSlice10ms(void)
 	if (gReducedService)
 		return;
 
+	BATTERY_Sample();
+
 	if (gCurrentFunction != FUNCTION_POWER_SAVE || !gRxIdleMode)
 		CheckRadioInterrupts();
 
+#ifdef ENABLE_CSS_DECODE
+	HandleCssDecode();
+#endif
+
 	if (gCurrentFunction == FUNCTION_TRANSMIT)
 	{	// transmitting
 #ifdef ENABLE_AUDIO_BAR
@@ -1147,8 +1350,8 @@ void APP_TimeSlice10ms(void)
 	if (gVoxResumeCountdown > 0)
 		gVoxResumeCountdown--;
 
-	if (gVoxPauseCountdown > 0)
-		gVoxPauseCountdown--;
+	if (gVoxPauseCountdown > 0 && --gVoxPauseCountdown == 0)
+		VOX_CheckKeyUp();
 #endif
 
 	if (gCurrentFunction == FUNCTION_TRANSMIT) {
@@ -1174,13 +1377,9 @@ void APP_TimeSlice10ms(void)
 					gAlarmState = ALARM_STATE_SITE_ALARM;
 
 					if(gEeprom.TAIL_TONE_ELIMINATION)
-						RADIO_SendCssTail();
-					BK4819_SetupPowerAmplifier(0, 0);
-					BK4819_ToggleGpioOut(BK4819_GPIO1_PIN29_PA_ENABLE, false);
-					BK4819_Enable_AfDac_DiscMode_TxDsp();
-					BK4819_ToggleGpioOut(BK4819_GPIO5_PIN1_RED, false);
-
-					GUI_DisplayScreen();
+						RADIO_SendCssTail(ALARM_StopTx);
+					else
+						ALARM_StopTx();
 				}
 				else {
 					gAlarmState = ALARM_STATE_TXALARM;
@@ -1199,8 +1398,8 @@ void APP_TimeSlice10ms(void)
 			}
 		}
 #endif
-		// repeater tail tone elimination
-		if (gRTTECountdown_10ms > 0) {
+		// repeater tail tone elimination, counted from the end of the roger
+		if (gRTTECountdown_10ms > 0 && !AUDIO_IsTonePlaying()) {
 			if (--gRTTECountdown_10ms == 0) {
 				//if (gCurrentFunction != FUNCTION_FOREGROUND)
 					FUNCTION_Select(FUNCTION_FOREGROUND);
@@ -1222,6 +1421,9 @@ void APP_TimeSlice10ms(void)
 
 
 	SCANNER_TimeSlice10ms();
+#ifdef ENABLE_FASTER_CHANNEL_SCAN
+	CHFRSCANNER_TimeSlice10ms();
+#endif
 
 #ifdef ENABLE_AIRCOPY
 	if (gScreenToDisplay == DISPLAY_AIRCOPY && gAircopyState == AIRCOPY_TRANSFER && gAirCopyIsSendMode == 1) {
@@ -1261,6 +1463,10 @@ void APP_TimeSlice500ms(void)
 	gNextTimeslice_500ms = false;
 	bool exit_menu = false;
 
+#ifdef ENABLE_CHANNEL_STATS
+	CHSTATS_TimeSlice500ms();
+#endif
+
 	// Skipped authentic device check
 
 	if (gKeypadLocked > 0)
@@ -1290,9 +1496,9 @@ void APP_TimeSlice500ms(void)
 		{
 			if (--gDTMF_RX_live_timeout == 0)
 			{
-				if (gDTMF_RX_live[0] != 0)
+				if (gDTMF_RX_live.Count > 0)
 				{
-					memset(gDTMF_RX_live, 0, sizeof(gDTMF_RX_live));
+					DTMF_RingClear(&gDTMF_RX_live);
 					gUpdateDisplay   = true;
 				}
 			}
@@ -1349,17 +1555,10 @@ void APP_TimeSlice500ms(void)
 
 	// Skipped authentic device check
 
-	if (gCurrentFunction != FUNCTION_TRANSMIT)
-	{
-
-		if ((gBatteryCheckCounter & 1) == 0)
-		{
-			BOARD_ADC_GetBatteryInfo(&gBatteryVoltages[gBatteryVoltageIndex++], &gBatteryCurrent);
-			if (gBatteryVoltageIndex > 3)
-				gBatteryVoltageIndex = 0;
-			BATTERY_GetReadings(true);
-		}
-	}
+	// the filtered voltage is compensated for the TX load, or held until that is known,
+	// it can be shown while transmitting
+	if ((gBatteryCheckCounter & 1) == 0)
+		BATTERY_GetReadings(true);
 
 	// regular display updates (once every 2 sec) - if need be
 	if ((gBatteryCheckCounter & 3) == 0)
@@ -1493,6 +1692,7 @@ static void ALARM_Off(void)
 
 	if (gAlarmState == ALARM_STATE_TXALARM || gAlarmState == ALARM_STATE_TX1750) {
 		RADIO_SendEndOfTransmission();
+		AUDIO_WaitTone();   // the registers are set up again right below
 	}
 
 	gAlarmState = ALARM_STATE_OFF;
@@ -1567,9 +1767,8 @@ static void ProcessKey(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
 
 		if (Key == KEY_EXIT && bKeyHeld) { // exit key held pressed
 			// clear the live DTMF decoder
-			if (gDTMF_RX_live[0] != 0) {
-				memset(gDTMF_RX_live, 0, sizeof(gDTMF_RX_live));
-				gDTMF_RX_live_timeout = 0;
+			if (gDTMF_RX_live.Count > 0) {
+				DTMF_clear_RX_live();
 				gUpdateDisplay        = true;
 			}
 
@@ -1691,6 +1890,9 @@ static void ProcessKey(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
 				goto Skip;
 			}
 
+			if (AUDIO_IsTonePlaying())   // the PTT ID is still going out
+				goto Skip;
+
 			if (Key == KEY_SIDE2) { // transmit 1750Hz tone
 				Code = 0xFE;
 			}
@@ -1732,11 +1934,7 @@ static void ProcessKey(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
 #if defined(ENABLE_ALARM) || defined(ENABLE_TX1750)
 		else if ((!bKeyHeld && bKeyPressed) || (gAlarmState == ALARM_STATE_TX1750 && bKeyHeld && !bKeyPressed)) {
 			ALARM_Off();
-
-			if (gEeprom.REPEATER_TAIL_TONE_ELIMINATION == 0)
-				FUNCTION_Select(FUNCTION_FOREGROUND);
-			else
-				gRTTECountdown_10ms = gEeprom.REPEATER_TAIL_TONE_ELIMINATION * 10;
+			APP_ReturnToRX();
 
 			if (Key == KEY_PTT)
 				gPttWasPressed  = true;
@@ -1760,11 +1958,6 @@ static void ProcessKey(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
 	}
 
 Skip:
-	if (gBeepToPlay != BEEP_NONE) {
-		AUDIO_PlayBeep(gBeepToPlay);
-		gBeepToPlay = BEEP_NONE;
-	}
-
 	if (gFlagAcceptSetting) {
 		gMenuCountdown = menu_timeout_500ms;
 
@@ -1867,7 +2060,14 @@ Skip:
 		MENU_ShowCurrentSetting();
 	}
 
+	// after the registers are set up, it would otherwise cut the beep short
+	if (gBeepToPlay != BEEP_NONE) {
+		AUDIO_PlayBeep(gBeepToPlay);
+		gBeepToPlay = BEEP_NONE;
+	}
+
 	if (gFlagPrepareTX) {
+		AUDIO_WaitTone();   // not on the air
 		RADIO_PrepareTX();
 		gFlagPrepareTX = false;
 	}
@@ -24,6 +24,7 @@
 #include "radio.h"
 
 void     APP_EndTransmission(void);
+void     APP_ReturnToRX(void);
 void     APP_StartListening(FUNCTION_Type_t function);
 uint32_t APP_SetFreqByStepAndLimits(VFO_Info_t *pInfo, int8_t direction, uint32_t lower, uint32_t upper);
 uint32_t APP_SetFrequencyByStep(VFO_Info_t *pInfo, int8_t direction);
@@ -1,8 +1,18 @@
 
+#include <stdlib.h>
+
 #include "app/app.h"
 #include "app/chFrScanner.h"
+#include "frequencies.h"
 #include "functions.h"
+#ifdef ENABLE_FASTER_CHANNEL_SCAN
+	#include "helper/rssi.h"
+	#ifdef ENABLE_PROFILING
+		#include "helper/profile.h"
+	#endif
+#endif
 #include "misc.h"
+#include "radio.h"
 #include "settings.h"
 
 int8_t            gScanStateDir;
@@ -30,6 +40,70 @@ uint32_t            lastFoundFrqOrChan;
 static void NextFreqChannel(void);
 static void NextMemChannel(void);
 
+#ifdef ENABLE_FASTER_CHANNEL_SCAN
+// how long each band takes to settle after a hop, exponentially smoothed,
+// in 1/16 of a tick, 0 until the band was measured
+static uint16_t scanDwell_q4[BAND_N_ELEM];
+static uint8_t  hopBand;
+static uint8_t  hopTicks;      // since the last RADIO_SetupRegisters
+static uint8_t  settleTicks;   // until RSSI, noise and glitch stopped moving, 0 while they still move
+static uint8_t  rssiSettleTicks;   // until RSSI alone stopped moving, 0 while it still moves
+static uint16_t hopRssi;
+static uint8_t  hopNoise;
+static uint8_t  hopGlitch;
+
+#ifdef ENABLE_PROFILING
+static uint32_t hopWindowStart_us;
+static uint16_t hopCount;
+#endif
+
+// the previous hop's measurement goes into its band's average,
+// the dwell for the hop just made comes out
+static uint8_t ScanDwell(void)
+{
+	if (hopTicks > 0) {
+		const uint16_t dwell = scanDwell_q4[hopBand] ? (scanDwell_q4[hopBand] + 8) / 16 : 9;
+		int            target;
+
+		if (settleTicks > 0)
+			target = settleTicks + scan_dwell_margin_10ms;
+		else if (hopTicks >= dwell)
+			target = scan_dwell_min_10ms;   // never settled, the old fixed dwell until traces show more is needed
+		else
+			target = 0;           // cut short by the user or a signal
+
+		if (target > 0) {
+			if (target < scan_dwell_min_10ms)
+				target = scan_dwell_min_10ms;
+			if (target > scan_dwell_max_10ms)
+				target = scan_dwell_max_10ms;
+
+			if (scanDwell_q4[hopBand] == 0)
+				scanDwell_q4[hopBand] = target * 16;
+			else
+				scanDwell_q4[hopBand] += (target * 16 - (int)scanDwell_q4[hopBand]) / 4;
+		}
+	}
+
+#ifdef ENABLE_PROFILING
+	const uint32_t now_us = PROFILE_GetTimeUs();
+	hopCount++;
+	if (now_us - hopWindowStart_us >= 1000000) {
+		gProfileCounters[PROFILE_SCAN_CHANNELS_PER_S] = hopCount * 1000u / ((now_us - hopWindowStart_us) / 1000);
+		hopWindowStart_us = now_us;
+		hopCount          = 0;
+	}
+#endif
+
+	hopBand     = gRxVfo->Band;
+	hopTicks        = 0;
+	settleTicks     = 0;
+	rssiSettleTicks = 0;
+
+	return scanDwell_q4[hopBand] ? (scanDwell_q4[hopBand] + 8) / 16 : 9;   // 90ms until measured
+}
+#endif
+
 void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_direction)
 {
 	if (storeBackupSettings) {
@@ -44,6 +118,14 @@ void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_directi
 	currentScanList = SCAN_NEXT_CHAN_SCANLIST1;
 	gScanStateDir    = scan_direction;
 
+#ifdef ENABLE_FASTER_CHANNEL_SCAN
+	hopTicks = 0;   // nothing measured yet
+	#ifdef ENABLE_PROFILING
+	hopWindowStart_us = PROFILE_GetTimeUs();
+	hopCount          = 0;
+	#endif
+#endif
+
 	if (IS_MR_CHANNEL(gNextMrChannel))
 	{	// channel mode
 		if (storeBackupSettings) {
@@ -154,6 +236,48 @@ void CHFRSCANNER_Stop(void)
 	gUpdateDisplay = true;
 }
 
+#ifdef ENABLE_FASTER_CHANNEL_SCAN
+void CHFRSCANNER_TimeSlice10ms(void)
+{
+	if (gScanStateDir == SCAN_OFF || gScanPauseMode || gScheduleScanListen ||
+	    gCurrentFunction != FUNCTION_FOREGROUND)
+		return;
+
+	if (hopTicks < 255)
+		hopTicks++;
+
+	const RSSI_Sample_t *pSample = RSSI_Get();
+	const uint16_t       Rssi    = pSample->Rssi;
+
+	const bool bRssiSteady = hopTicks > 1 && abs((int)Rssi - (int)hopRssi) <= scan_rssi_settle_delta;
+
+	// the dwell learned is for the squelch, it decides on noise and glitch as well, all three must be steady
+	if (settleTicks == 0 && bRssiSteady &&
+	    abs((int)pSample->ExNoise - (int)hopNoise) <= scan_noise_settle_delta &&
+	    abs((int)pSample->Glitch - (int)hopGlitch) <= scan_glitch_settle_delta)
+	{
+		settleTicks = hopTicks;
+	}
+
+	hopRssi   = Rssi;
+	hopNoise  = pSample->ExNoise;
+	hopGlitch = pSample->Glitch;
+
+	// the early exit only looks at RSSI, so only RSSI has to be steady for it
+	if (rssiSettleTicks == 0) {
+		if (bRssiSteady)
+			rssiSettleTicks = hopTicks;
+		return;
+	}
+
+	// settled well below the squelch open level, no signal to wait for
+	if (hopTicks >= scan_early_exit_10ms && Rssi + scan_early_exit_margin < gRxVfo->SquelchOpenRSSIThresh) {
+		gScanPauseDelayIn_10ms = 0;
+		gScheduleScanListen    = true;
+	}
+}
+#endif
+
 static void NextFreqChannel(void)
 {
 #ifdef ENABLE_SCAN_RANGES
@@ -169,7 +293,7 @@ static void NextFreqChannel(void)
 	RADIO_SetupRegisters(true);
 
 #ifdef ENABLE_FASTER_CHANNEL_SCAN
-	gScanPauseDelayIn_10ms = 9;   // 90ms
+	gScanPauseDelayIn_10ms = ScanDwell();
 #else
 	gScanPauseDelayIn_10ms = scan_pause_delay_in_6_10ms;
 #endif
@@ -262,7 +386,7 @@ static void NextMemChannel(void)
 	}
 
 #ifdef ENABLE_FASTER_CHANNEL_SCAN
-	gScanPauseDelayIn_10ms = 9;  // 90ms .. <= ~60ms it misses signals (squelch response and/or PLL lock time) ?
+	gScanPauseDelayIn_10ms = ScanDwell();  // <= ~60ms missed signals (squelch response and/or PLL lock time), the measured dwell stays >= 90ms
 #else
 	gScanPauseDelayIn_10ms = scan_pause_delay_in_3_10ms;
 #endif
@@ -19,5 +19,8 @@ void CHFRSCANNER_Found(void);
 void CHFRSCANNER_Stop(void);
 void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_direction);
 void CHFRSCANNER_ContinueScanning(void);
+#ifdef ENABLE_FASTER_CHANNEL_SCAN
+void CHFRSCANNER_TimeSlice10ms(void);
+#endif
 
 #endif
\ No newline at end of file
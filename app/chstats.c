@@ -0,0 +1,302 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <assert.h>
+#include <string.h>
+
+#include "app/chstats.h"
+#include "audio.h"
+#ifdef ENABLE_CHANNEL_STATS_SAVE
+	#include "driver/eeprom.h"
+#endif
+#include "functions.h"
+#include "radio.h"
+#include "settings.h"
+#include "ui/ui.h"
+
+CHSTATS_Channel_t gChannelStats[MR_CHANNEL_LAST + 1];
+uint8_t           gChannelStatsOrder[MR_CHANNEL_LAST + 1];
+uint8_t           gChannelStatsCursor;
+
+static volatile uint32_t gStatsTick_10ms;
+static volatile uint32_t gOpenTicks_10ms;   // since the squelch opened
+static volatile uint8_t  gOpenChannel = 0xFF;
+
+#ifdef ENABLE_CHANNEL_STATS_SAVE
+// the busiest channels are kept in the gap after the channel names, the
+// EEPROM only burns blocks whose contents changed and only every few minutes
+#define CHSTATS_EEPROM_ADDRESS 0x1BD0
+#define CHSTATS_SAVED          6
+#define CHSTATS_SAVE_500ms     (10 * 60 * 2)
+
+typedef struct {
+	uint8_t  Channel;          // 0xFF = unused
+	uint8_t  PeakRssi;
+	uint16_t Hits;
+	uint32_t OpenTime_10ms;
+} CHSTATS_Record_t;
+
+static_assert(sizeof(CHSTATS_Record_t) == 8);
+static_assert(CHSTATS_EEPROM_ADDRESS + CHSTATS_SAVED * sizeof(CHSTATS_Record_t) <= 0x1C00);
+
+static bool     gStatsDirty;
+static uint16_t gSaveCountdown_500ms = CHSTATS_SAVE_500ms;
+#endif
+
+static bool IsBusier(const uint8_t a, const uint8_t b)
+{
+	const CHSTATS_Channel_t *pA = &gChannelStats[a];
+	const CHSTATS_Channel_t *pB = &gChannelStats[b];
+
+	if (pA->OpenTime_10ms != pB->OpenTime_10ms)
+		return pA->OpenTime_10ms > pB->OpenTime_10ms;
+	return pA->Hits > pB->Hits;
+}
+
+// the counters only grow, so a channel only ever moves up, usually by a
+// place or two, the order stays sorted without ever sorting all of it
+static void Promote(const uint8_t Channel)
+{
+	uint8_t Rank = gChannelStats[Channel].Rank;
+
+	while (Rank > 0 && IsBusier(Channel, gChannelStatsOrder[Rank - 1])) {
+		const uint8_t Other = gChannelStatsOrder[Rank - 1];
+		gChannelStatsOrder[Rank] = Other;
+		gChannelStats[Other].Rank = Rank;
+		Rank--;
+	}
+
+	gChannelStatsOrder[Rank] = Channel;
+	gChannelStats[Channel].Rank = Rank;
+
+#ifdef ENABLE_CHANNEL_STATS_SAVE
+	gStatsDirty = true;
+#endif
+}
+
+static void ResetOrder(void)
+{
+	for (unsigned int i = 0; i < ARRAY_SIZE(gChannelStatsOrder); i++) {
+		gChannelStatsOrder[i] = i;
+		gChannelStats[i].Rank = i;
+	}
+}
+
+#ifdef ENABLE_CHANNEL_STATS_SAVE
+static void Save(void)
+{
+	for (unsigned int i = 0; i < CHSTATS_SAVED; i++) {
+		const uint8_t            Channel = gChannelStatsOrder[i];
+		const CHSTATS_Channel_t *pStats  = &gChannelStats[Channel];
+		CHSTATS_Record_t         Record;
+
+		memset(&Record, 0xFF, sizeof(Record));
+		if (pStats->Hits > 0) {
+			Record.Channel       = Channel;
+			Record.PeakRssi      = pStats->PeakRssi;
+			Record.Hits          = pStats->Hits;
+			Record.OpenTime_10ms = pStats->OpenTime_10ms;
+		}
+
+		EEPROM_WriteBuffer(CHSTATS_EEPROM_ADDRESS + i * sizeof(Record), &Record);
+	}
+
+	gStatsDirty = false;
+}
+#endif
+
+void CHSTATS_Init(void)
+{
+	ResetOrder();
+
+#ifdef ENABLE_CHANNEL_STATS_SAVE
+	CHSTATS_Record_t Records[CHSTATS_SAVED];
+
+	EEPROM_ReadBuffer(CHSTATS_EEPROM_ADDRESS, Records, sizeof(Records));
+
+	for (unsigned int i = 0; i < CHSTATS_SAVED; i++) {
+		if (!IS_MR_CHANNEL(Records[i].Channel) || Records[i].Hits == 0xFFFF)
+			continue;
+
+		CHSTATS_Channel_t *pStats = &gChannelStats[Records[i].Channel];
+		pStats->PeakRssi      = Records[i].PeakRssi;
+		pStats->Hits          = Records[i].Hits;
+		pStats->OpenTime_10ms = Records[i].OpenTime_10ms;
+		Promote(Records[i].Channel);
+	}
+
+	gStatsDirty = false;
+#endif
+}
+
+// called from the systick interrupt
+void CHSTATS_Tick(void)
+{
+	gStatsTick_10ms++;
+	if (gOpenChannel != 0xFF)
+		gOpenTicks_10ms++;
+}
+
+uint32_t CHSTATS_GetTick(void)
+{
+	return gStatsTick_10ms;
+}
+
+void CHSTATS_Open(uint16_t Channel)
+{
+	if (!IS_MR_CHANNEL(Channel))
+		return;
+
+	CHSTATS_Close();
+
+	CHSTATS_Channel_t *pStats = &gChannelStats[Channel];
+	if (pStats->Hits < UINT16_MAX)
+		pStats->Hits++;
+
+	gOpenTicks_10ms = 0;
+	gOpenChannel    = Channel;
+	Promote(Channel);
+}
+
+void CHSTATS_Close(void)
+{
+	const uint8_t Channel = gOpenChannel;
+	if (Channel == 0xFF)
+		return;
+
+	// stop the tick counting before reading it
+	gOpenChannel = 0xFF;
+
+	CHSTATS_Channel_t *pStats = &gChannelStats[Channel];
+	pStats->OpenTime_10ms += gOpenTicks_10ms;
+	pStats->LastHeard_10ms = gStatsTick_10ms | 1;
+	Promote(Channel);
+}
+
+void CHSTATS_SampleRssi(uint16_t Rssi)
+{
+	const uint8_t Channel = gOpenChannel;
+	if (Channel == 0xFF)
+		return;
+
+	Rssi >>= 1;
+	if (Rssi > UINT8_MAX)
+		Rssi = UINT8_MAX;
+	if (Rssi > gChannelStats[Channel].PeakRssi)
+		gChannelStats[Channel].PeakRssi = Rssi;
+}
+
+void CHSTATS_Reset(void)
+{
+	const uint8_t Channel = gOpenChannel;
+
+	gOpenChannel = 0xFF;
+	memset(gChannelStats, 0, sizeof(gChannelStats));
+	ResetOrder();
+	gChannelStatsCursor = 0;
+
+	if (Channel != 0xFF)
+		CHSTATS_Open(Channel);
+
+#ifdef ENABLE_CHANNEL_STATS_SAVE
+	gStatsDirty = true;
+#endif
+}
+
+void CHSTATS_TimeSlice500ms(void)
+{
+#ifdef ENABLE_CHANNEL_STATS_SAVE
+	if (gSaveCountdown_500ms > 0)
+		gSaveCountdown_500ms--;
+
+	// batch the writes, and never while the radio is busy
+	if (gStatsDirty && gSaveCountdown_500ms == 0 && gCurrentFunction == FUNCTION_FOREGROUND) {
+		Save();
+		gSaveCountdown_500ms = CHSTATS_SAVE_500ms;
+	}
+#endif
+}
+
+void CHSTATS_Show(void)
+{
+	gChannelStatsCursor   = 0;
+	gRequestDisplayScreen = DISPLAY_CHSTATS;
+}
+
+static uint8_t CountActive(void)
+{
+	uint8_t Count = 0;
+	while (Count < ARRAY_SIZE(gChannelStatsOrder) && gChannelStats[gChannelStatsOrder[Count]].Hits > 0)
+		Count++;
+	return Count;
+}
+
+void CHSTATS_ProcessKeys(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
+{
+	if (!bKeyPressed)
+		return;
+
+	const uint8_t Active = CountActive();
+
+	switch (Key) {
+		case KEY_UP:
+			if (gChannelStatsCursor > 0)
+				gChannelStatsCursor--;
+			gRequestDisplayScreen = DISPLAY_CHSTATS;
+			break;
+
+		case KEY_DOWN:
+			if (gChannelStatsCursor + 1 < Active)
+				gChannelStatsCursor++;
+			gRequestDisplayScreen = DISPLAY_CHSTATS;
+			break;
+
+		case KEY_MENU:
+			if (bKeyHeld || gChannelStatsCursor >= Active)
+				break;
+			{	// listen to the selected channel
+				const uint8_t Channel = gChannelStatsOrder[gChannelStatsCursor];
+				gEeprom.MrChannel[gEeprom.TX_VFO]     = Channel;
+				gEeprom.ScreenChannel[gEeprom.TX_VFO] = Channel;
+				gRequestSaveVFO                       = true;
+				gVfoConfigureMode                     = VFO_CONFIGURE_RELOAD;
+				gRequestDisplayScreen                 = DISPLAY_MAIN;
+				gBeepToPlay                           = BEEP_1KHZ_60MS_OPTIONAL;
+			}
+			break;
+
+		case KEY_STAR:
+			if (bKeyHeld) {   // long press clears the counters
+				CHSTATS_Reset();
+				gRequestDisplayScreen = DISPLAY_CHSTATS;
+				gBeepToPlay           = BEEP_1KHZ_60MS_OPTIONAL;
+			}
+			break;
+
+		case KEY_EXIT:
+			if (!bKeyHeld) {
+				gRequestDisplayScreen = DISPLAY_MAIN;
+				gBeepToPlay           = BEEP_1KHZ_60MS_OPTIONAL;
+			}
+			break;
+
+		default:
+			if (!bKeyHeld)
+				gBeepToPlay = BEEP_500HZ_60MS_DOUBLE_BEEP_OPTIONAL;
+			break;
+	}
+}
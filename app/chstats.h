@@ -0,0 +1,50 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#ifndef APP_CHSTATS_H
+#define APP_CHSTATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "driver/keyboard.h"
+#include "misc.h"
+
+typedef struct {
+	uint32_t LastHeard_10ms;   // tick the squelch last closed, 0 = never heard
+	uint32_t OpenTime_10ms;    // total time with the squelch open
+	uint16_t Hits;             // squelch openings
+	uint8_t  PeakRssi;         // strongest RSSI / 2
+	uint8_t  Rank;             // position in gChannelStatsOrder
+} CHSTATS_Channel_t;
+
+extern CHSTATS_Channel_t gChannelStats[MR_CHANNEL_LAST + 1];
+extern uint8_t           gChannelStatsOrder[MR_CHANNEL_LAST + 1]; // busiest first
+extern uint8_t           gChannelStatsCursor;
+
+void     CHSTATS_Init(void);
+void     CHSTATS_Tick(void);
+uint32_t CHSTATS_GetTick(void);
+void     CHSTATS_Open(uint16_t Channel);
+void     CHSTATS_Close(void);
+void     CHSTATS_SampleRssi(uint16_t Rssi);
+void     CHSTATS_Reset(void);
+void     CHSTATS_TimeSlice500ms(void);
+void     CHSTATS_Show(void);
+void     CHSTATS_ProcessKeys(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld);
+
+#endif
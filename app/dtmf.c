@@ -14,6 +14,7 @@
  *     limitations under the License.
  */
 
+#include <assert.h>
 #include <string.h>
 #include <stdio.h>   // NULL
 
@@ -27,7 +28,6 @@
 #include "driver/bk4819.h"
 #include "driver/eeprom.h"
 #include "driver/gpio.h"
-#include "driver/system.h"
 #include "dtmf.h"
 #include "external/printf/printf.h"
 #include "misc.h"
@@ -41,12 +41,11 @@ uint8_t           gDTMF_InputBox_Index = 0;
 bool              gDTMF_InputMode      = false;
 uint8_t           gDTMF_PreviousIndex  = 0;
 
-char              gDTMF_RX_live[20];
+DTMF_Ring_t       gDTMF_RX_live;
 uint8_t           gDTMF_RX_live_timeout = 0;
 
 #ifdef ENABLE_DTMF_CALLING
-char              gDTMF_RX[17];
-uint8_t           gDTMF_RX_index   = 0;
+DTMF_Ring_t       gDTMF_RX;
 uint8_t           gDTMF_RX_timeout = 0;
 bool              gDTMF_RX_pending = false;
 
@@ -69,45 +68,199 @@ bool              gDTMF_IsGroupCall;
 DTMF_ReplyState_t gDTMF_ReplyState;
 
 #ifdef ENABLE_DTMF_CALLING
+enum {
+	MATCH_KILL = 0,
+	MATCH_REVIVE,
+	MATCH_ACK,
+	MATCH_REPLY,
+	MATCH_CALL,
+	MATCH_COUNT
+};
+
+// shift-and matcher: bit i of State is set while the last i + 1 received
+// characters satisfy the first i + 1 template positions
+typedef struct {
+	uint16_t Mask[16];    // per DTMF symbol, the template positions it satisfies
+	uint16_t Group;       // positions satisfied only by the group call code
+	uint16_t State;
+	uint16_t GroupState;  // the State prefixes that needed the group call code
+	uint8_t  Length;      // 0 = template can never match
+} Matcher_t;
+
+static Matcher_t gMatchers[MATCH_COUNT];
+static uint8_t   gGroupSymbol;
+static uint8_t   gMatched;        // MATCH_ bits seen since the last DTMF_HandleRequest()
+static uint8_t   gMatchedGroup;   // .. and which of those needed the group call code
+static char      gMatchedCallee[3];
+static char      gMatchedCaller[3];
+
 void DTMF_clear_RX(void)
 {
 	gDTMF_RX_timeout = 0;
-	gDTMF_RX_index   = 0;
 	gDTMF_RX_pending = false;
-	memset(gDTMF_RX, 0, sizeof(gDTMF_RX));
+	gMatched         = 0;
+	gMatchedGroup    = 0;
+	DTMF_RingClear(&gDTMF_RX);
+}
+#endif
+
+void DTMF_RingClear(DTMF_Ring_t *pRing)
+{
+	pRing->Head  = 0;
+	pRing->Count = 0;
+}
+
+void DTMF_RingPush(DTMF_Ring_t *pRing, const char c)
+{
+	pRing->Buffer[pRing->Head] = c;
+	pRing->Head = (pRing->Head + 1) & (sizeof(pRing->Buffer) - 1);
+	if (pRing->Count < sizeof(pRing->Buffer))
+		pRing->Count++;
+}
+
+unsigned int DTMF_RingCopy(const DTMF_Ring_t *pRing, char *pOut, const unsigned int max)
+{	// the newest 'max' characters, oldest first
+	const unsigned int count = MIN((unsigned int)pRing->Count, max);
+	const unsigned int start = pRing->Head - count;
+
+	for (unsigned int i = 0; i < count; i++)
+		pOut[i] = pRing->Buffer[(start + i) & (sizeof(pRing->Buffer) - 1)];
+	pOut[count] = 0;
+
+	return count;
+}
+
+void DTMF_clear_RX_live(void)
+{
+	gDTMF_RX_live_timeout = 0;
+	DTMF_RingClear(&gDTMF_RX_live);
 }
+
+// DTMF transmissions are built into a tone script and go out from the
+// timeslice, the persist and interval times are all multiples of 10ms.
+// The longest string sent is a call with our ID appended, each digit takes
+// a tone and a gap, the 16 spare steps cover the lead-in, lead-out and Apollo tone
+#define DTMF_TX_DIGITS_MAX 22
+
+#ifdef ENABLE_DTMF_CALLING
+static_assert(sizeof(gDTMF_String) + sizeof(gEeprom.ANI_DTMF_ID) - 1 <= DTMF_TX_DIGITS_MAX);
 #endif
+static_assert(sizeof(gEeprom.DTMF_UP_CODE)   - 1 <= DTMF_TX_DIGITS_MAX);
+static_assert(sizeof(gEeprom.DTMF_DOWN_CODE) - 1 <= DTMF_TX_DIGITS_MAX);
+
+static AUDIO_ToneStep_t gDTMF_TxScript[2 * DTMF_TX_DIGITS_MAX + 16];
+static unsigned int     gDTMF_TxLength;
+static bool             gDTMF_TxSpeaker;   // gEnableSpeaker was set for the side tone
+static void           (*gDTMF_TxDone)(void);
+
+static void TxBegin(void)
+{
+	if (AUDIO_IsTonePlaying())
+		AUDIO_StopTone();   // it may still be playing from the script buffer
+
+	gDTMF_TxLength  = 0;
+	gDTMF_TxSpeaker = false;
+}
+
+static void TxStep(const AUDIO_ToneOp_t Op, const uint16_t Wait_ms, const uint16_t Value)
+{
+	if (gDTMF_TxLength < ARRAY_SIZE(gDTMF_TxScript) - 1)   // keep room for the end
+		gDTMF_TxScript[gDTMF_TxLength++] = (AUDIO_ToneStep_t){ .Op = Op, .Wait_10ms = Wait_ms / 10, .Value = Value };
+}
+
+static void TxDigits(const char *pString, const bool bDelayFirst)
+{
+	for (unsigned int i = 0; pString[i] != 0 && i < DTMF_TX_DIGITS_MAX; i++)
+	{
+		uint16_t Persist;
+		if (bDelayFirst && i == 0)
+			Persist = gEeprom.DTMF_FIRST_CODE_PERSIST_TIME;
+		else
+		if (pString[i] == '*' || pString[i] == '#')
+			Persist = gEeprom.DTMF_HASH_CODE_PERSIST_TIME;
+		else
+			Persist = gEeprom.DTMF_CODE_PERSIST_TIME;
+
+		TxStep(AUDIO_TONE_DTMF_DIGIT, Persist, pString[i]);
+		TxStep(AUDIO_TONE_MUTE, gEeprom.DTMF_CODE_INTERVAL_TIME, 0);
+	}
+}
+
+// level 0 ~ 127
+static void TxSingleTone(const uint16_t tone_Hz, const uint16_t duration_ms, const unsigned int level, const bool play_speaker)
+{
+	if (play_speaker)
+		TxStep(AUDIO_TONE_PATH_ON, 0, 0);
+
+	TxStep(AUDIO_TONE_TX, 0, level);
+	TxStep(AUDIO_TONE_AF, 50, play_speaker ? BK4819_AF_BEEP : BK4819_AF_MUTE);
+	TxStep(AUDIO_TONE_FREQ, 0, tone_Hz);
+	TxStep(AUDIO_TONE_UNMUTE, duration_ms, 0);
+	TxStep(AUDIO_TONE_MUTE, 0, 0);
+
+	if (play_speaker) {
+		TxStep(AUDIO_TONE_PATH_OFF, 0, 0);
+		TxStep(AUDIO_TONE_AF, 0, BK4819_AF_MUTE);
+	}
+
+	TxStep(AUDIO_TONE_TX_OFF, 0, 0);
+	TxStep(AUDIO_TONE_UNMUTE, 0, 0);
+}
+
+static void TxDone(void)
+{
+	void (*pDone)(void) = gDTMF_TxDone;
+
+	if (gDTMF_TxSpeaker)
+		gEnableSpeaker = false;
 
-void DTMF_SendEndOfTransmission(void)
+	gDTMF_TxSpeaker = false;
+	gDTMF_TxDone    = NULL;
+
+	if (pDone != NULL)
+		pDone();
+}
+
+static void TxPlay(void (*pDone)(void))
+{
+	if (gDTMF_TxLength == 0) {
+		if (pDone != NULL)
+			pDone();
+		return;
+	}
+
+	gDTMF_TxScript[gDTMF_TxLength++] = (AUDIO_ToneStep_t){ .Op = AUDIO_TONE_END };
+	gDTMF_TxDone = pDone;
+
+	AUDIO_PlayTones(gDTMF_TxScript, 0, TxDone);
+}
+
+void DTMF_SendEndOfTransmission(void (*pDone)(void))
 {
+	TxBegin();
+
 	if (gCurrentVfo->DTMF_PTT_ID_TX_MODE == PTT_ID_APOLLO)
-		BK4819_PlaySingleTone(2475, 250, 28, gEeprom.DTMF_SIDE_TONE);
+		TxSingleTone(2475, 250, 28, gEeprom.DTMF_SIDE_TONE);
 	else if ((gCurrentVfo->DTMF_PTT_ID_TX_MODE == PTT_ID_TX_DOWN || gCurrentVfo->DTMF_PTT_ID_TX_MODE == PTT_ID_BOTH)
 #ifdef ENABLE_DTMF_CALLING
 		&& gDTMF_CallState == DTMF_CALL_STATE_NONE
 #endif
 	) {	// end-of-tx
 		if (gEeprom.DTMF_SIDE_TONE) {
-			AUDIO_AudioPathOn();
-			gEnableSpeaker = true;
-			SYSTEM_DelayMs(60);
+			gEnableSpeaker  = true;
+			gDTMF_TxSpeaker = true;
+			TxStep(AUDIO_TONE_PATH_ON, 60, 0);
 		}
 
-		BK4819_EnterDTMF_TX(gEeprom.DTMF_SIDE_TONE);
-
-		BK4819_PlayDTMFString(
-				gEeprom.DTMF_DOWN_CODE,
-				0,
-				gEeprom.DTMF_FIRST_CODE_PERSIST_TIME,
-				gEeprom.DTMF_HASH_CODE_PERSIST_TIME,
-				gEeprom.DTMF_CODE_PERSIST_TIME,
-				gEeprom.DTMF_CODE_INTERVAL_TIME);
-
-		AUDIO_AudioPathOff();
-		gEnableSpeaker = false;
+		TxStep(AUDIO_TONE_DTMF_ENTER, 0, gEeprom.DTMF_SIDE_TONE);
+		TxDigits(gEeprom.DTMF_DOWN_CODE, false);
+		TxStep(AUDIO_TONE_PATH_OFF, 0, 0);
+		gDTMF_TxSpeaker = true;
 	}
 
-	BK4819_ExitDTMF_TX(true);
+	TxStep(AUDIO_TONE_DTMF_EXIT, 0, true);
+
+	TxPlay(pDone);
 }
 
 bool DTMF_ValidateCodes(char *pCode, const unsigned int size)
@@ -191,20 +344,123 @@ char DTMF_GetCharacter(const unsigned int code)
 	}
 }
 #ifdef ENABLE_DTMF_CALLING
-static bool CompareMessage(const char *pMsg, const char *pTemplate, const unsigned int size, const bool bCheckGroup)
-{
+static uint8_t GetSymbol(const char c)
+{	// 0..15, or 0xff if 'c' isn't a DTMF character
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'A' && c <= 'D')
+		return c - 'A' + 10;
+	if (c == '*')
+		return 14;
+	if (c == '#')
+		return 15;
+	return 0xff;
+}
+
+static void CompileTemplate(Matcher_t *pMatcher, const char *pTemplate, const bool bCheckGroup)
+{	// '?' matches any character
+	memset(pMatcher, 0, sizeof(*pMatcher));
+
 	unsigned int i;
-	for (i = 0; i < size; i++)
+	for (i = 0; pTemplate[i] != 0; i++)
 	{
-		if (pMsg[i] != pTemplate[i])
+		const uint16_t bit    = 1u << i;
+		const uint8_t  symbol = GetSymbol(pTemplate[i]);
+
+		if (i >= 8 * sizeof(pMatcher->State))
+			return;   // longer than the RX history, can never match
+
+		if (pTemplate[i] == '?')
+		{
+			for (unsigned int k = 0; k < ARRAY_SIZE(pMatcher->Mask); k++)
+				pMatcher->Mask[k] |= bit;
+			continue;
+		}
+
+		if (symbol >= ARRAY_SIZE(pMatcher->Mask))
+			return;   // not a DTMF character, can never match
+
+		pMatcher->Mask[symbol] |= bit;
+
+		if (bCheckGroup && gGroupSymbol < ARRAY_SIZE(pMatcher->Mask) && gGroupSymbol != symbol)
 		{
-			if (!bCheckGroup || pMsg[i] != gEeprom.DTMF_GROUP_CALL_CODE)
-				return false;
-			gDTMF_IsGroupCall = true;
+			pMatcher->Mask[gGroupSymbol] |= bit;
+			pMatcher->Group              |= bit;
 		}
 	}
 
-	return true;
+	pMatcher->Length = i;
+}
+
+static void CompileTemplates(void)
+{	// done once per burst, not per character
+	char String[24];
+
+	gGroupSymbol = GetSymbol(gEeprom.DTMF_GROUP_CALL_CODE);
+
+	sprintf(String, "%s%c%s", gEeprom.ANI_DTMF_ID, gEeprom.DTMF_SEPARATE_CODE, gEeprom.KILL_CODE);
+	CompileTemplate(&gMatchers[MATCH_KILL], String, true);
+
+	sprintf(String, "%s%c%s", gEeprom.ANI_DTMF_ID, gEeprom.DTMF_SEPARATE_CODE, gEeprom.REVIVE_CODE);
+	CompileTemplate(&gMatchers[MATCH_REVIVE], String, true);
+
+	CompileTemplate(&gMatchers[MATCH_ACK], "AB", true);
+
+	sprintf(String, "%s%c%s", gDTMF_String, gEeprom.DTMF_SEPARATE_CODE, "AAAAA");
+	CompileTemplate(&gMatchers[MATCH_REPLY], String, false);
+
+	// our ID, then the caller's 3 character ID
+	sprintf(String, "%s%c???", gEeprom.ANI_DTMF_ID, gEeprom.DTMF_SEPARATE_CODE);
+	CompileTemplate(&gMatchers[MATCH_CALL], String, true);
+}
+
+static char PeekRX(const unsigned int age)
+{	// 0 = the newest character
+	return gDTMF_RX.Buffer[(gDTMF_RX.Head - 1 - age) & (sizeof(gDTMF_RX.Buffer) - 1)];
+}
+
+void DTMF_RX_Append(const char c)
+{	// cheap enough to run for every character of a fast burst
+	const uint8_t symbol = GetSymbol(c);
+	if (symbol >= ARRAY_SIZE(gMatchers[0].Mask))
+		return;
+
+	if (gDTMF_RX.Count == 0)
+		CompileTemplates();
+
+	DTMF_RingPush(&gDTMF_RX, c);
+
+	for (unsigned int i = 0; i < MATCH_COUNT; i++)
+	{
+		Matcher_t     *pMatcher = &gMatchers[i];
+		const uint16_t advanced = (pMatcher->State << 1) | 1u;
+
+		pMatcher->GroupState = (pMatcher->GroupState << 1) & pMatcher->Mask[symbol];
+		if (symbol == gGroupSymbol)
+			pMatcher->GroupState |= advanced & pMatcher->Group;
+		pMatcher->State = advanced & pMatcher->Mask[symbol];
+
+		if (pMatcher->Length == 0 || !(pMatcher->State & (1u << (pMatcher->Length - 1))))
+			continue;
+
+		gMatched |= 1u << i;
+		if (pMatcher->GroupState & (1u << (pMatcher->Length - 1)))
+			gMatchedGroup |= 1u << i;
+		else
+			gMatchedGroup &= ~(1u << i);
+
+		if (i == MATCH_CALL)
+		{	// callee leads the match, caller ends it
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				gMatchedCallee[k] = PeekRX(pMatcher->Length - 1 - k);
+				gMatchedCaller[k] = PeekRX(2 - k);
+			}
+		}
+	}
+
+	gDTMF_RX_timeout = DTMF_RX_timeout_500ms;  // time till we delete it
+	gDTMF_RX_pending = true;
 }
 
 DTMF_CallMode_t DTMF_CheckGroupCall(const char *pMsg, const unsigned int size)
@@ -239,10 +495,7 @@ void DTMF_Append(const char code)
 
 #ifdef ENABLE_DTMF_CALLING
 void DTMF_HandleRequest(void)
-{	// proccess the RX'ed DTMF characters
-
-	char         String[21];
-	unsigned int Offset;
+{	// act on the templates DTMF_RX_Append() matched
 
 	if (!gDTMF_RX_pending)
 		return;   // nothing new received
@@ -259,110 +512,82 @@ void DTMF_HandleRequest(void)
 		return;
 	}
 
-	gDTMF_RX_pending = false;
-
-	if (gDTMF_RX_index >= 9)
-	{	// look for the KILL code
-
-		sprintf(String, "%s%c%s", gEeprom.ANI_DTMF_ID, gEeprom.DTMF_SEPARATE_CODE, gEeprom.KILL_CODE);
+	const uint8_t matched = gMatched;
 
-		Offset = gDTMF_RX_index - strlen(String);
-
-		if (CompareMessage(gDTMF_RX + Offset, String, strlen(String), true))
-		{	// bugger
-
-			if (gEeprom.PERMIT_REMOTE_KILL)
-			{
-				gSetting_KILLED = true;      // oooerr !
+	gDTMF_RX_pending = false;
+	gMatched         = 0;
 
-				DTMF_clear_RX();
+	if (matched & (1u << MATCH_KILL))
+	{	// bugger
 
-				SETTINGS_SaveSettings();
+		if (gEeprom.PERMIT_REMOTE_KILL)
+		{
+			gSetting_KILLED = true;      // oooerr !
 
-				gDTMF_ReplyState = DTMF_REPLY_AB;
+			DTMF_clear_RX();
 
-				#ifdef ENABLE_FMRADIO
-					if (gFmRadioMode)
-					{
-						FM_TurnOff();
-						GUI_SelectNextDisplay(DISPLAY_MAIN);
-					}
-				#endif
-			}
-			else
-			{
-				gDTMF_ReplyState = DTMF_REPLY_NONE;
-			}
+			SETTINGS_SaveSettings();
 
-			gDTMF_CallState = DTMF_CALL_STATE_NONE;
+			gDTMF_ReplyState = DTMF_REPLY_AB;
 
-			gUpdateDisplay  = true;
-			gUpdateStatus   = true;
-			return;
+			#ifdef ENABLE_FMRADIO
+				if (gFmRadioMode)
+				{
+					FM_TurnOff();
+					GUI_SelectNextDisplay(DISPLAY_MAIN);
+				}
+			#endif
+		}
+		else
+		{
+			gDTMF_ReplyState = DTMF_REPLY_NONE;
 		}
-	}
-
-	if (gDTMF_RX_index >= 9)
-	{	// look for the REVIVE code
 
-		sprintf(String, "%s%c%s", gEeprom.ANI_DTMF_ID, gEeprom.DTMF_SEPARATE_CODE, gEeprom.REVIVE_CODE);
+		gDTMF_CallState = DTMF_CALL_STATE_NONE;
 
-		Offset = gDTMF_RX_index - strlen(String);
+		gUpdateDisplay  = true;
+		gUpdateStatus   = true;
+		return;
+	}
 
-		if (CompareMessage(gDTMF_RX + Offset, String, strlen(String), true))
-		{	// shit, we're back !
+	if (matched & (1u << MATCH_REVIVE))
+	{	// shit, we're back !
 
-			gSetting_KILLED  = false;
+		gSetting_KILLED  = false;
 
-			DTMF_clear_RX();
+		DTMF_clear_RX();
 
-			SETTINGS_SaveSettings();
+		SETTINGS_SaveSettings();
 
-			gDTMF_ReplyState = DTMF_REPLY_AB;
-			gDTMF_CallState  = DTMF_CALL_STATE_NONE;
+		gDTMF_ReplyState = DTMF_REPLY_AB;
+		gDTMF_CallState  = DTMF_CALL_STATE_NONE;
 
-			gUpdateDisplay   = true;
-			gUpdateStatus    = true;
-			return;
-		}
+		gUpdateDisplay   = true;
+		gUpdateStatus    = true;
+		return;
 	}
 
-	if (gDTMF_RX_index >= 2)
-	{	// look for ACK reply
-		char *pPrintStr = "AB";
-
-		Offset = gDTMF_RX_index - strlen(pPrintStr);
+	if (matched & (1u << MATCH_ACK))
+	{	// ends with "AB"
 
-		if (CompareMessage(gDTMF_RX + Offset, pPrintStr, strlen(pPrintStr), true)) {
-			// ends with "AB"
-
-			if (gDTMF_ReplyState != DTMF_REPLY_NONE)          // 1of11
-//			if (gDTMF_CallState != DTMF_CALL_STATE_NONE)      // 1of11
-//			if (gDTMF_CallState == DTMF_CALL_STATE_CALL_OUT)  // 1of11
-			{
-				gDTMF_State = DTMF_STATE_TX_SUCC;
-				DTMF_clear_RX();
-				gUpdateDisplay = true;
-				return;
-			}
+		if (gDTMF_ReplyState != DTMF_REPLY_NONE)          // 1of11
+//		if (gDTMF_CallState != DTMF_CALL_STATE_NONE)      // 1of11
+//		if (gDTMF_CallState == DTMF_CALL_STATE_CALL_OUT)  // 1of11
+		{
+			gDTMF_State = DTMF_STATE_TX_SUCC;
+			DTMF_clear_RX();
+			gUpdateDisplay = true;
+			return;
 		}
 	}
 
 	if (gDTMF_CallState == DTMF_CALL_STATE_CALL_OUT &&
 	    gDTMF_CallMode  == DTMF_CALL_MODE_NOT_GROUP &&
-	    gDTMF_RX_index >= 9)
-	{	// waiting for a reply
-
-		sprintf(String, "%s%c%s", gDTMF_String, gEeprom.DTMF_SEPARATE_CODE, "AAAAA");
-
-		Offset = gDTMF_RX_index - strlen(String);
-
-		if (CompareMessage(gDTMF_RX + Offset, String, strlen(String), false))
-		{	// we got a response
-			gDTMF_State    = DTMF_STATE_CALL_OUT_RSP;
-			DTMF_clear_RX();
-			gUpdateDisplay = true;
-		}
+	    (matched & (1u << MATCH_REPLY)))
+	{	// we got a response
+		gDTMF_State    = DTMF_STATE_CALL_OUT_RSP;
+		DTMF_clear_RX();
+		gUpdateDisplay = true;
 	}
 
 	if (gSetting_KILLED || gDTMF_CallState != DTMF_CALL_STATE_NONE)
@@ -370,62 +595,57 @@ void DTMF_HandleRequest(void)
 		return;
 	}
 
-	if (gDTMF_RX_index >= 7)
-	{	// see if we're being called
-
-		gDTMF_IsGroupCall = false;
-
-		sprintf(String, "%s%c", gEeprom.ANI_DTMF_ID, gEeprom.DTMF_SEPARATE_CODE);
-
-		Offset = gDTMF_RX_index - strlen(String) - 3;
+	if (matched & (1u << MATCH_CALL))
+	{	// it's for us !
 
-		if (CompareMessage(gDTMF_RX + Offset, String, strlen(String), true))
-		{	// it's for us !
+		gDTMF_IsGroupCall = (gMatchedGroup & (1u << MATCH_CALL)) != 0;
 
-			gDTMF_CallState = DTMF_CALL_STATE_RECEIVED;
+		gDTMF_CallState = DTMF_CALL_STATE_RECEIVED;
 
-			memset(gDTMF_Callee, 0, sizeof(gDTMF_Callee));
-			memset(gDTMF_Caller, 0, sizeof(gDTMF_Caller));
-			memcpy(gDTMF_Callee, gDTMF_RX + Offset + 0, 3);
-			memcpy(gDTMF_Caller, gDTMF_RX + Offset + 4, 3);
+		memset(gDTMF_Callee, 0, sizeof(gDTMF_Callee));
+		memset(gDTMF_Caller, 0, sizeof(gDTMF_Caller));
+		memcpy(gDTMF_Callee, gMatchedCallee, sizeof(gMatchedCallee));
+		memcpy(gDTMF_Caller, gMatchedCaller, sizeof(gMatchedCaller));
 
-			DTMF_clear_RX();
-
-			gUpdateDisplay = true;
+		DTMF_clear_RX();
 
-			switch (gEeprom.DTMF_DECODE_RESPONSE)
-			{
-				case DTMF_DEC_RESPONSE_BOTH:
-					gDTMF_DecodeRingCountdown_500ms = DTMF_decode_ring_countdown_500ms;
-					[[fallthrough]];
-				case DTMF_DEC_RESPONSE_REPLY:
-					gDTMF_ReplyState = DTMF_REPLY_AAAAA;
-					break;
-				case DTMF_DEC_RESPONSE_RING:
-					gDTMF_DecodeRingCountdown_500ms = DTMF_decode_ring_countdown_500ms;
-					break;
-				default:
-				case DTMF_DEC_RESPONSE_NONE:
-					gDTMF_DecodeRingCountdown_500ms = 0;
-					gDTMF_ReplyState = DTMF_REPLY_NONE;
-					break;
-			}
+		gUpdateDisplay = true;
 
-			if (gDTMF_IsGroupCall)
+		switch (gEeprom.DTMF_DECODE_RESPONSE)
+		{
+			case DTMF_DEC_RESPONSE_BOTH:
+				gDTMF_DecodeRingCountdown_500ms = DTMF_decode_ring_countdown_500ms;
+				[[fallthrough]];
+			case DTMF_DEC_RESPONSE_REPLY:
+				gDTMF_ReplyState = DTMF_REPLY_AAAAA;
+				break;
+			case DTMF_DEC_RESPONSE_RING:
+				gDTMF_DecodeRingCountdown_500ms = DTMF_decode_ring_countdown_500ms;
+				break;
+			default:
+			case DTMF_DEC_RESPONSE_NONE:
+				gDTMF_DecodeRingCountdown_500ms = 0;
 				gDTMF_ReplyState = DTMF_REPLY_NONE;
+				break;
 		}
+
+		if (gDTMF_IsGroupCall)
+			gDTMF_ReplyState = DTMF_REPLY_NONE;
 	}
 }
 #endif
 
-void DTMF_Reply(void)
+// the PTT ID, call or reply digits, then the Apollo tone
+void DTMF_Reply(void (*pDone)(void))
 {
 	uint16_t    Delay;
 #ifdef ENABLE_DTMF_CALLING
-	char        String[23];
+	char        String[DTMF_TX_DIGITS_MAX + 1];
 #endif
 	const char *pString = NULL;
 
+	TxBegin();
+
 	switch (gDTMF_ReplyState)
 	{
 		case DTMF_REPLY_ANI:
@@ -462,8 +682,7 @@ void DTMF_Reply(void)
 			    gCurrentVfo->DTMF_PTT_ID_TX_MODE == PTT_ID_OFF    ||
 			    gCurrentVfo->DTMF_PTT_ID_TX_MODE == PTT_ID_TX_DOWN)
 			{
-				gDTMF_ReplyState = DTMF_REPLY_NONE;
-				return;
+				break;
 			}
 
 			// send TX-UP DTMF
@@ -473,32 +692,28 @@ void DTMF_Reply(void)
 
 	gDTMF_ReplyState = DTMF_REPLY_NONE;
 
-	if (pString == NULL)
-		return;
-
-	Delay = (gEeprom.DTMF_PRELOAD_TIME < 200) ? 200 : gEeprom.DTMF_PRELOAD_TIME;
-
-	if (gEeprom.DTMF_SIDE_TONE)
-	{	// the user will also hear the transmitted tones
-		AUDIO_AudioPathOn();
-		gEnableSpeaker = true;
-	}
-
-	SYSTEM_DelayMs(Delay);
+	if (pString != NULL)
+	{
+		Delay = (gEeprom.DTMF_PRELOAD_TIME < 200) ? 200 : gEeprom.DTMF_PRELOAD_TIME;
 
-	BK4819_EnterDTMF_TX(gEeprom.DTMF_SIDE_TONE);
+		if (gEeprom.DTMF_SIDE_TONE)
+		{	// the user will also hear the transmitted tones
+			gEnableSpeaker = true;
+			TxStep(AUDIO_TONE_PATH_ON, Delay, 0);
+		}
+		else
+			TxStep(AUDIO_TONE_WAIT, Delay, 0);
 
-	BK4819_PlayDTMFString(
-		pString,
-		1,
-		gEeprom.DTMF_FIRST_CODE_PERSIST_TIME,
-		gEeprom.DTMF_HASH_CODE_PERSIST_TIME,
-		gEeprom.DTMF_CODE_PERSIST_TIME,
-		gEeprom.DTMF_CODE_INTERVAL_TIME);
+		TxStep(AUDIO_TONE_DTMF_ENTER, 0, gEeprom.DTMF_SIDE_TONE);
+		TxDigits(pString, true);
+		TxStep(AUDIO_TONE_PATH_OFF, 0, 0);
+		TxStep(AUDIO_TONE_DTMF_EXIT, 0, false);
 
-	AUDIO_AudioPathOff();
+		gDTMF_TxSpeaker = true;
+	}
 
-	gEnableSpeaker = false;
+	if (gCurrentVfo->DTMF_PTT_ID_TX_MODE == PTT_ID_APOLLO)
+		TxSingleTone(2525, 250, 0, gEeprom.DTMF_SIDE_TONE);
 
-	BK4819_ExitDTMF_TX(false);
+	TxPlay(pDone);
 }
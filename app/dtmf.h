@@ -68,6 +68,13 @@ enum {  // seconds
 
 typedef enum DTMF_CallMode_t DTMF_CallMode_t;
 
+// circular history of received DTMF characters, the oldest are overwritten
+typedef struct {
+	char    Buffer[16];   // power of two
+	uint8_t Head;         // next write position
+	uint8_t Count;        // characters held, saturates at the buffer size
+} DTMF_Ring_t;
+
 extern char              gDTMF_String[15];
 
 extern char              gDTMF_InputBox[15];
@@ -75,7 +82,7 @@ extern uint8_t           gDTMF_InputBox_Index;
 extern bool              gDTMF_InputMode;
 extern uint8_t           gDTMF_PreviousIndex;
 
-extern char              gDTMF_RX_live[20];
+extern DTMF_Ring_t       gDTMF_RX_live;
 extern uint8_t           gDTMF_RX_live_timeout;
 
 extern DTMF_ReplyState_t gDTMF_ReplyState;
@@ -84,13 +91,16 @@ bool DTMF_ValidateCodes(char *pCode, const unsigned int size);
 char DTMF_GetCharacter(const unsigned int code);
 void DTMF_clear_input_box(void);
 void DTMF_Append(const char code);
-void DTMF_Reply(void);
-void DTMF_SendEndOfTransmission(void);
+void DTMF_Reply(void (*pDone)(void));
+void DTMF_SendEndOfTransmission(void (*pDone)(void));
+void DTMF_RingClear(DTMF_Ring_t *pRing);
+void DTMF_RingPush(DTMF_Ring_t *pRing, const char c);
+unsigned int DTMF_RingCopy(const DTMF_Ring_t *pRing, char *pOut, const unsigned int max);
+void DTMF_clear_RX_live(void);
 
 #ifdef ENABLE_DTMF_CALLING
 
-extern char              gDTMF_RX[17];
-extern uint8_t           gDTMF_RX_index;
+extern DTMF_Ring_t       gDTMF_RX;
 extern uint8_t           gDTMF_RX_timeout;
 extern bool              gDTMF_RX_pending;
 
@@ -109,6 +119,7 @@ extern bool              gDTMF_IsTx;
 extern uint8_t           gDTMF_TxStopCountdown_500ms;
 
 void DTMF_clear_RX(void);
+void DTMF_RX_Append(const char c);
 DTMF_CallMode_t DTMF_CheckGroupCall(const char *pDTMF, const unsigned int size);
 bool DTMF_GetContact(const int Index, char *pContact);
 bool DTMF_FindContact(const char *pContact, char *pResult);
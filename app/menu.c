@@ -514,6 +514,7 @@ void MENU_AcceptSetting(void)
 				if (gEeprom.VOX_SWITCH)
 					gEeprom.VOX_LEVEL = gSubMenuSelection - 1;
 				SETTINGS_LoadCalibration();
+				SETTINGS_LoadRssiCalibration();   // not part of SETTINGS_LoadCalibration, boot defers it
 				gFlagReconfigureVfos = true;
 				gUpdateStatus        = true;
 				break;
@@ -598,6 +599,7 @@ void MENU_AcceptSetting(void)
 		case MENU_MIC:
 			gEeprom.MIC_SENSITIVITY = gSubMenuSelection;
 			SETTINGS_LoadCalibration();
+			SETTINGS_LoadRssiCalibration();
 			gFlagReconfigureVfos = true;
 			break;
 
@@ -665,8 +667,7 @@ void MENU_AcceptSetting(void)
 
 		case MENU_D_LIVE_DEC:
 			gSetting_live_DTMF_decoder = gSubMenuSelection;
-			gDTMF_RX_live_timeout = 0;
-			memset(gDTMF_RX_live, 0, sizeof(gDTMF_RX_live));
+			DTMF_clear_RX_live();
 			if (!gSetting_live_DTMF_decoder)
 				BK4819_DisableDTMF();
 			gFlagReconfigureVfos     = true;
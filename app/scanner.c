@@ -22,6 +22,9 @@
 #include "audio.h"
 #include "driver/bk4819.h"
 #include "frequencies.h"
+#ifdef ENABLE_PROFILING
+	#include "helper/profile.h"
+#endif
 #include "misc.h"
 #include "radio.h"
 #include "settings.h"
@@ -41,6 +44,19 @@ bool              gScanUseCssResult;
 STEP_Setting_t    stepSetting;
 uint8_t           scanHitCount;
 
+static bool       cssArmed;      // tone detectors tuned to the frequency candidate
+static bool       cssFound;      // tone/code confirmed, waits for the frequency lock
+static uint8_t    cssHitCount;   // matching tone/code readings in a row
+
+#ifdef ENABLE_PROFILING
+static uint32_t   scanStart_us;
+
+static void SCANNER_ProfilePhase(PROFILE_Counter_t counter)
+{
+	gProfileCounters[counter] = (PROFILE_GetTimeUs() - scanStart_us) / 1000;
+}
+#endif
+
 
 static void SCANNER_Key_DIGITS(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
 {
@@ -355,6 +371,9 @@ void SCANNER_Start(bool singleFreq)
 	gScanCssResultCode     = 0xFF;
 	gScanCssResultType     = 0xFF;
 	scanHitCount          = 0;
+	cssArmed               = false;
+	cssFound               = false;
+	cssHitCount            = 0;
 	gScanUseCssResult      = false;
 	g_CxCSS_TAIL_Found     = false;
 	g_CDCSS_Lost           = false;
@@ -366,6 +385,13 @@ void SCANNER_Start(bool singleFreq)
 	g_SquelchLost          = false;
 	gScannerSaveState      = SCAN_SAVE_NO_PROMPT;
 	gScanProgressIndicator = 0;
+
+#ifdef ENABLE_PROFILING
+	scanStart_us = PROFILE_GetTimeUs();
+	gProfileCounters[PROFILE_SCAN_FREQ_HIT_MS]  = 0;
+	gProfileCounters[PROFILE_SCAN_FREQ_LOCK_MS] = 0;
+	gProfileCounters[PROFILE_SCAN_CSS_MS]       = 0;
+#endif
 }
 
 void SCANNER_Stop(void)
@@ -384,6 +410,65 @@ void SCANNER_Stop(void)
 	}
 }
 
+// one reading of the tone detectors, false when they have nothing yet
+static bool SCANNER_ReadCss(void)
+{
+	uint32_t cdcssFreq;
+	uint16_t ctcssFreq;
+	DCS_CodeType_t Type;
+	uint8_t        Code;
+	uint8_t        Hits;
+
+	const BK4819_CssScanResult_t scanResult = BK4819_GetCxCSSScanResult(&cdcssFreq, &ctcssFreq);
+	if (scanResult == BK4819_CSS_RESULT_NOT_FOUND)
+		return false;
+
+	if (scanResult == BK4819_CSS_RESULT_CDCSS) {
+		Type = CODE_TYPE_DIGITAL;
+		Code = DCS_GetCdcssCode(cdcssFreq);
+		Hits = scan_cdcss_hits;
+	}
+	else {
+		Type = CODE_TYPE_CONTINUOUS_TONE;
+		Code = DCS_GetCtcssCode(ctcssFreq);
+		Hits = scan_ctcss_hits;
+	}
+
+	if (Code == 0xFF)
+		return true;
+
+	if (Code == gScanCssResultCode && Type == gScanCssResultType)
+		cssHitCount++;
+	else
+		cssHitCount = 1;
+
+	gScanCssResultType = Type;
+	gScanCssResultCode = Code;
+
+	if (cssHitCount >= Hits && !cssFound) {
+		cssFound = true;
+#ifdef ENABLE_PROFILING
+		SCANNER_ProfilePhase(PROFILE_SCAN_CSS_MS);
+#endif
+	}
+
+	return true;
+}
+
+static void SCANNER_CssFound(void)
+{
+	gScanCssState     = SCAN_CSS_STATE_FOUND;
+	gScanUseCssResult = true;
+	gUpdateStatus     = true;
+
+	if(gCssBackgroundScan) {
+		gCssBackgroundScan = false;
+		MENU_CssScanFound();
+	}
+	else
+		GUI_SelectNextDisplay(DISPLAY_SCANNER);
+}
+
 void SCANNER_TimeSlice10ms(void)
 {
 	if (!SCANNER_IsScanning())
@@ -401,6 +486,8 @@ void SCANNER_TimeSlice10ms(void)
 	switch (gScanCssState) {
 		case SCAN_CSS_STATE_OFF: {
 			// must be RF frequency scanning if we're here ?
+			// the tone detectors listen on the candidate from its first hit on,
+			// they are read once per frequency result
 			uint32_t result;
 			if (!BK4819_GetFrequencyScanResult(&result))
 				break;
@@ -410,29 +497,57 @@ void SCANNER_TimeSlice10ms(void)
 
 			if (delta < 0)
 				delta = -delta;
-			if (delta < 100)
-				scanHitCount++;
-			else
-				scanHitCount = 0;
 
 			BK4819_DisableFrequencyScan();
 
-			if (scanHitCount < 3) {
-				BK4819_EnableFrequencyScan();
+			if (delta < scan_freq_tolerance_10Hz) {
+				scanHitCount++;
+				// once confirmed the code is kept, a stray reading can't replace it
+				if (cssArmed && !cssFound)
+					SCANNER_ReadCss();
 			}
 			else {
-				BK4819_SetScanFrequency(gScanFrequency);
-				gScanCssResultCode     = 0xFF;
-				gScanCssResultType     = 0xFF;
-				scanHitCount          = 0;
-				gScanUseCssResult      = false;
+				// the candidate moved, so did whatever the tone detectors heard
+				scanHitCount       = 0;
+				cssArmed           = false;
+				cssFound           = false;
+				cssHitCount        = 0;
+				gScanCssResultCode = 0xFF;
+				gScanCssResultType = 0xFF;
+			}
+
+			if (scanHitCount >= scan_freq_hits) {
+#ifdef ENABLE_PROFILING
+				SCANNER_ProfilePhase(PROFILE_SCAN_FREQ_LOCK_MS);
+#endif
 				gScanProgressIndicator = 0;
-				gScanCssState          = SCAN_CSS_STATE_SCANNING;
+
+				if (cssFound) {
+					BK4819_Disable();
+					SCANNER_CssFound();
+					break;
+				}
+
+				BK4819_SetScanFrequency(gScanFrequency);
+				gScanCssState = SCAN_CSS_STATE_SCANNING;
 
 				if(!gCssBackgroundScan)
 					GUI_SelectNextDisplay(DISPLAY_SCANNER);
 
-				gUpdateStatus          = true;
+				gUpdateStatus = true;
+			}
+			else {
+				if (scanHitCount > 0) {
+#ifdef ENABLE_PROFILING
+					if (!cssArmed)
+						SCANNER_ProfilePhase(PROFILE_SCAN_FREQ_HIT_MS);
+#endif
+					// (re)start the tone detectors on the latest candidate
+					BK4819_SetScanFrequency(gScanFrequency);
+					cssArmed = true;
+				}
+
+				BK4819_EnableFrequencyScan();
 			}
 
 			gScanDelay_10ms = scan_delay_10ms;
@@ -440,58 +555,18 @@ void SCANNER_TimeSlice10ms(void)
 			break;
 		}
 		case SCAN_CSS_STATE_SCANNING: {
-			uint32_t cdcssFreq;
-			uint16_t ctcssFreq;
-			BK4819_CssScanResult_t scanResult = BK4819_GetCxCSSScanResult(&cdcssFreq, &ctcssFreq);
-			if (scanResult == BK4819_CSS_RESULT_NOT_FOUND)
+			if (!SCANNER_ReadCss())
 				break;
 
 			BK4819_Disable();
 
-			if (scanResult == BK4819_CSS_RESULT_CDCSS) {
-				const uint8_t Code = DCS_GetCdcssCode(cdcssFreq);
-				if (Code != 0xFF)
-				{
-					gScanCssResultCode = Code;
-					gScanCssResultType = CODE_TYPE_DIGITAL;
-					gScanCssState      = SCAN_CSS_STATE_FOUND;
-					gScanUseCssResult  = true;
-					gUpdateStatus      = true;
-				}
-			}
-			else if (scanResult == BK4819_CSS_RESULT_CTCSS) {
-				const uint8_t Code = DCS_GetCtcssCode(ctcssFreq);
-				if (Code != 0xFF) {
-					if (Code == gScanCssResultCode && gScanCssResultType == CODE_TYPE_CONTINUOUS_TONE) {
-						if (++scanHitCount >= 2) {
-							gScanCssState     = SCAN_CSS_STATE_FOUND;
-							gScanUseCssResult = true;
-							gUpdateStatus     = true;
-						}
-					}
-					else
-						scanHitCount = 0;
-
-					gScanCssResultType = CODE_TYPE_CONTINUOUS_TONE;
-					gScanCssResultCode = Code;
-				}
-			}
-
-			if (gScanCssState < SCAN_CSS_STATE_FOUND) { // scanning or off
+			if (!cssFound) {
 				BK4819_SetScanFrequency(gScanFrequency);
 				gScanDelay_10ms = scan_delay_10ms;
 				break;
 			}
 
-			if(gCssBackgroundScan) {
-				gCssBackgroundScan = false;
-				if(gScanUseCssResult)
-					MENU_CssScanFound();
-			}
-			else
-				GUI_SelectNextDisplay(DISPLAY_SCANNER);
-
-
+			SCANNER_CssFound();
 			break;
 		}
 		default:
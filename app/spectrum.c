@@ -24,6 +24,12 @@
 
 #include "driver/backlight.h"
 #include "frequencies.h"
+#include "helper/fixed.h"
+#include "helper/format.h"
+#include "helper/rssi.h"
+#ifdef ENABLE_RSSI_TRACE
+#include "helper/rssi_trace.h"
+#endif
 #include "ui/helper.h"
 #include "ui/main.h"
 
@@ -62,6 +68,16 @@ static uint16_t blacklistFreqs[15];
 static uint8_t blacklistFreqsIdx;
 #endif
 
+#ifdef ENABLE_SPECTRUM_CHANNELS
+// the scan list memory channels, one bar each, their frequencies are read
+// from the EEPROM once so the sweep never waits on I2C or a squelch dwell
+static uint32_t channelFreqs[128];
+static uint8_t channelNums[128];
+static uint8_t channelCount;
+static uint8_t channelBarWidth;
+static bool channelMode;
+#endif
+
 const char *bwOptions[] = {"  25k", "12.5k", "6.25k"};
 const uint8_t modulationTypeTuneSteps[] = {100, 50, 10};
 const uint8_t modTypeReg47Values[] = {1, 7, 5};
@@ -273,12 +289,25 @@ static void ResetPeak() {
   peak.rssi = 0;
 }
 
+static bool IsChannelMode() {
+#ifdef ENABLE_SPECTRUM_CHANNELS
+  return channelMode;
+#else
+  return false;
+#endif
+}
+
 bool IsCenterMode() { return settings.scanStepIndex < S_STEP_2_5kHz; }
 // scan step in 0.01khz
 uint16_t GetScanStep() { return scanStepValues[settings.scanStepIndex]; }
 
 uint16_t GetStepsCount()
 {
+#ifdef ENABLE_SPECTRUM_CHANNELS
+  if (channelMode) {
+    return channelCount;
+  }
+#endif
 #ifdef ENABLE_SCAN_RANGES
   if(gScanRangeStart) {
     return (gScanRangeStop - gScanRangeStart) / GetScanStep();
@@ -314,10 +343,11 @@ uint8_t GetBWRegValueForScan() {
 uint16_t GetRssi() {
   // SYSTICK_DelayUs(800);
   // testing autodelay based on Glitch value
-  while ((BK4819_ReadRegister(0x63) & 0b11111111) >= 255) {
+  // only the glitch register while waiting, the full sample once it settled
+  while (BK4819_GetGlitchIndicator() >= 255) {
     SYSTICK_DelayUs(100);
   }
-  uint16_t rssi = BK4819_GetRSSI();
+  uint16_t rssi = RSSI_Read()->Rssi;
 #ifdef ENABLE_AM_FIX
   if(settings.modulationType==MODULATION_AM && gSetting_AM_fix)
     rssi += AM_fix_get_gain_diff()*2;
@@ -367,7 +397,12 @@ static void ResetScanStats() {
 static void InitScan() {
   ResetScanStats();
   scanInfo.i = 0;
-  scanInfo.f = GetFStart();
+#ifdef ENABLE_SPECTRUM_CHANNELS
+  if (channelMode)
+    scanInfo.f = channelFreqs[0];
+  else
+#endif
+    scanInfo.f = GetFStart();
 
   scanInfo.scanStep = GetScanStep();
   scanInfo.measurementsCount = GetStepsCount();
@@ -432,7 +467,12 @@ static void SetRssiHistory(uint16_t idx, uint16_t rssi)
 {
 #ifdef ENABLE_SCAN_RANGES
   if(scanInfo.measurementsCount > 128) {
-    uint8_t i = (uint32_t)ARRAY_SIZE(rssiHistory) * 1000 / scanInfo.measurementsCount * idx / 1000;
+    // ARRAY_SIZE(rssiHistory) * 1000 / measurementsCount * idx / 1000
+    static FIXED_Divider_t countDiv, thousandDiv;
+    FIXED_SetDivisor(&countDiv, scanInfo.measurementsCount);
+    FIXED_SetDivisor(&thousandDiv, 1000);
+    const uint32_t scale = FIXED_Divide((uint32_t)ARRAY_SIZE(rssiHistory) * 1000, &countDiv);
+    uint8_t i = FIXED_Divide(scale * idx, &thousandDiv);
     if(rssiHistory[i] < rssi || isListening)
       rssiHistory[i] = rssi;
     rssiHistory[(i+1)%128] = 0;
@@ -488,6 +528,9 @@ static void UpdateDBMax(bool inc) {
 }
 
 static void UpdateScanStep(bool inc) {
+  if (IsChannelMode()) {
+    return;
+  }
   if (inc) {
     settings.scanStepIndex = settings.scanStepIndex != S_STEP_100_0kHz ? settings.scanStepIndex + 1 : 0;
   } else {
@@ -501,7 +544,9 @@ static void UpdateScanStep(bool inc) {
 }
 
 static void UpdateCurrentFreq(bool inc) {
-  if (inc && currentFreq < F_MAX) {
+  if (IsChannelMode()) {
+    return;
+  } else if (inc && currentFreq < F_MAX) {
     currentFreq += settings.frequencyChangeStep;
   } else if (!inc && currentFreq > F_MIN) {
     currentFreq -= settings.frequencyChangeStep;
@@ -567,6 +612,9 @@ static void ToggleBacklight() {
 }
 
 static void ToggleStepsCount() {
+  if (IsChannelMode()) {
+    return;
+  }
   if (settings.stepsCount == STEPS_128) {
     settings.stepsCount = STEPS_16;
   } else {
@@ -662,6 +710,61 @@ static bool IsBlacklisted(uint16_t idx)
 }
 #endif
 
+#ifdef ENABLE_SPECTRUM_CHANNELS
+// members of the default scan list, all channels when it's set to both
+static bool LoadChannels() {
+  const uint8_t list = gEeprom.SCAN_LIST_DEFAULT;
+
+  channelCount = 0;
+  for (uint8_t ch = MR_CHANNEL_FIRST;
+       IS_MR_CHANNEL(ch) && channelCount < ARRAY_SIZE(channelFreqs); ch++) {
+    if (!RADIO_CheckValidChannel(ch, false, 0)) {
+      continue;
+    }
+    const ChannelAttributes_t att = gMR_ChannelAttributes[ch];
+    if ((list == 0 && !att.scanlist1) || (list == 1 && !att.scanlist2)) {
+      continue;
+    }
+    channelFreqs[channelCount] = SETTINGS_FetchChannelFrequency(ch);
+    channelNums[channelCount++] = ch;
+  }
+
+  if (channelCount == 0) {
+    return false;
+  }
+  channelBarWidth = ARRAY_SIZE(rssiHistory) / channelCount;
+  return true;
+}
+
+static void ToggleChannelMode() {
+  if (!channelMode && !LoadChannels()) {
+    return;
+  }
+  channelMode = !channelMode;
+  memset(rssiHistory, 0, sizeof(rssiHistory));
+  ResetBlacklist();
+  RelaunchScan();
+  redrawScreen = true;
+}
+
+// leave the spectrum with the VFO on the peak's memory channel
+static void TuneToPeakChannel() {
+  if (peak.f == 0) {
+    return;
+  }
+  const uint8_t ch = channelNums[peak.i];
+  gEeprom.MrChannel[vfo] = ch;
+  gEeprom.ScreenChannel[vfo] = ch;
+  gRequestSaveVFO = true;
+  gVfoConfigureMode = VFO_CONFIGURE_RELOAD;
+  DeInitSpectrum();
+}
+
+static uint8_t ChannelBarX(uint16_t i) {
+  return i * channelBarWidth;
+}
+#endif
+
 // Draw things
 
 // applied x2 to prevent initial rounding
@@ -674,7 +777,11 @@ uint8_t Rssi2PX(uint16_t rssi, uint8_t pxMin, uint8_t pxMax) {
 
   int dbm = clamp(Rssi2DBm(rssi) << 1, DB_MIN, DB_MAX);
 
-  return ((dbm - DB_MIN) * PX_RANGE + DB_RANGE / 2) / DB_RANGE + pxMin;
+  // called for every column, the range only changes with the settings
+  static FIXED_Divider_t rangeDiv;
+  FIXED_SetDivisor(&rangeDiv, DB_RANGE);
+
+  return FIXED_Divide((dbm - DB_MIN) * PX_RANGE + DB_RANGE / 2, &rangeDiv) + pxMin;
 }
 
 uint8_t Rssi2Y(uint16_t rssi) {
@@ -682,6 +789,22 @@ uint8_t Rssi2Y(uint16_t rssi) {
 }
 
 static void DrawSpectrum() {
+#ifdef ENABLE_SPECTRUM_CHANNELS
+  if (channelMode) {
+    // keep a gap between the bars when they're wide enough
+    const uint8_t w = channelBarWidth > 2 ? channelBarWidth - 1 : channelBarWidth;
+    for (uint8_t i = 0; i < channelCount; ++i) {
+      uint16_t rssi = rssiHistory[i];
+      if (rssi == RSSI_MAX_VALUE) {
+        continue;
+      }
+      for (uint8_t x = ChannelBarX(i); x < ChannelBarX(i) + w; ++x) {
+        DrawVLine(Rssi2Y(rssi), DrawingEndY, x, true);
+      }
+    }
+    return;
+  }
+#endif
   for (uint8_t x = 0; x < 128; ++x) {
     uint16_t rssi = rssiHistory[x >> settings.stepsCount];
     if (rssi != RSSI_MAX_VALUE) {
@@ -695,16 +818,16 @@ static void DrawStatus() {
   sprintf(String, "%d/%d P:%d T:%d", settings.dbMin, settings.dbMax,
           Rssi2DBm(peak.rssi), Rssi2DBm(settings.rssiTriggerLevel));
 #else
-  sprintf(String, "%d/%d", settings.dbMin, settings.dbMax);
+  char *p = FORMAT_Signed(String, settings.dbMin, 0);
+  *p++ = '/';
+  FORMAT_Signed(p, settings.dbMax, 0);
 #endif
   GUI_DisplaySmallest(String, 0, 1, true, true);
 
-  BOARD_ADC_GetBatteryInfo(&gBatteryVoltages[gBatteryCheckCounter++ % 4],
-                           &gBatteryCurrent);
+  BATTERY_Sample();
 
-  uint16_t voltage = (gBatteryVoltages[0] + gBatteryVoltages[1] +
-                      gBatteryVoltages[2] + gBatteryVoltages[3]) /
-                     4 * 760 / gBatteryCalibration[3];
+  uint16_t voltage =
+      BATTERY_GetFilteredVoltage() * 760 / gBatteryCalibration[3];
 
   unsigned perc = BATTERY_VoltsToPercent(voltage);
 
@@ -725,7 +848,7 @@ static void DrawStatus() {
 }
 
 static void DrawF(uint32_t f) {
-  sprintf(String, "%u.%05u", f / 100000, f % 100000);
+  FORMAT_Frequency(String, f, 5, 0, ' ');
   UI_PrintStringSmallNormal(String, 8, 127, 0);
 
   sprintf(String, "%3s", gModulationStr[settings.modulationType]);
@@ -736,27 +859,64 @@ static void DrawF(uint32_t f) {
 
 static void DrawNums() {
 
+#ifdef ENABLE_SPECTRUM_CHANNELS
+  if (channelMode) {
+    char *p = FORMAT_Unsigned(String, channelCount, 0, ' ');
+    strcpy(p, "ch");
+    GUI_DisplaySmallest(String, 0, 1, false, true);
+    GUI_DisplaySmallest(gEeprom.SCAN_LIST_DEFAULT == 0   ? "L1"
+                        : gEeprom.SCAN_LIST_DEFAULT == 1 ? "L2"
+                                                         : "ALL",
+                        0, 7, false, true);
+
+    // label the peak with its memory channel
+    if (peak.f) {
+      const uint8_t ch = channelNums[peak.i];
+      p = FORMAT_Channel(String, "M", ch + 1, 0);
+      *p++ = ' ';
+      SETTINGS_FetchChannelName(p, ch);
+      GUI_DisplaySmallest(String, 0, 49, false, true);
+
+      FORMAT_Unsigned(String, ch + 1, 0, ' ');
+      uint8_t x = ChannelBarX(peak.i);
+      uint8_t y = Rssi2Y(peak.rssi);
+      GUI_DisplaySmallest(String, x < 116 ? x : 116, y > 8 ? y - 7 : 1, false,
+                          true);
+    }
+    return;
+  }
+#endif
+
   if (currentState == SPECTRUM) {
-    sprintf(String, "%ux", GetStepsCount());
+    char *p = FORMAT_Unsigned(String, GetStepsCount(), 0, ' ');
+    *p++ = 'x';
+    *p = 0;
     GUI_DisplaySmallest(String, 0, 1, false, true);
-    sprintf(String, "%u.%02uk", GetScanStep() / 100, GetScanStep() % 100);
+    p = FORMAT_Decimal(String, GetScanStep(), 2, 2, 0, ' ');
+    *p++ = 'k';
+    *p = 0;
     GUI_DisplaySmallest(String, 0, 7, false, true);
   }
 
   if (IsCenterMode()) {
-    sprintf(String, "%u.%05u \x7F%u.%02uk", currentFreq / 100000,
-            currentFreq % 100000, settings.frequencyChangeStep / 100,
-            settings.frequencyChangeStep % 100);
+    char *p = FORMAT_Frequency(String, currentFreq, 5, 0, ' ');
+    *p++ = ' ';
+    *p++ = '\x7F';
+    p = FORMAT_Decimal(p, settings.frequencyChangeStep, 2, 2, 0, ' ');
+    *p++ = 'k';
+    *p = 0;
     GUI_DisplaySmallest(String, 36, 49, false, true);
   } else {
-    sprintf(String, "%u.%05u", GetFStart() / 100000, GetFStart() % 100000);
+    FORMAT_Frequency(String, GetFStart(), 5, 0, ' ');
     GUI_DisplaySmallest(String, 0, 49, false, true);
 
-    sprintf(String, "\x7F%u.%02uk", settings.frequencyChangeStep / 100,
-            settings.frequencyChangeStep % 100);
+    String[0] = '\x7F';
+    char *p = FORMAT_Decimal(String + 1, settings.frequencyChangeStep, 2, 2, 0, ' ');
+    *p++ = 'k';
+    *p = 0;
     GUI_DisplaySmallest(String, 48, 49, false, true);
 
-    sprintf(String, "%u.%05u", GetFEnd() / 100000, GetFEnd() % 100000);
+    FORMAT_Frequency(String, GetFEnd(), 5, 0, ' ');
     GUI_DisplaySmallest(String, 93, 49, false, true);
   }
 }
@@ -771,6 +931,14 @@ static void DrawRssiTriggerLevel() {
 }
 
 static void DrawTicks() {
+#ifdef ENABLE_SPECTRUM_CHANNELS
+  if (channelMode) {
+    for (uint8_t i = 0; i < channelCount; ++i) {
+      gFrameBuffer[5][ChannelBarX(i)] |= 0b00000011;
+    }
+    return;
+  }
+#endif
   uint32_t f = GetFStart();
   uint32_t span = GetFEnd() - GetFStart();
   uint32_t step = span / 128;
@@ -848,6 +1016,12 @@ static void OnKeyDown(uint8_t key) {
     UpdateRssiTriggerLevel(false);
     break;
   case KEY_5:
+#ifdef ENABLE_SPECTRUM_CHANNELS
+    if (channelMode) {
+      TuneToPeakChannel();
+      break;
+    }
+#endif
 #ifdef ENABLE_SCAN_RANGES
     if(!gScanRangeStart)
 #endif
@@ -873,6 +1047,9 @@ static void OnKeyDown(uint8_t key) {
     TuneToPeak();
     break;
   case KEY_MENU:
+#ifdef ENABLE_SPECTRUM_CHANNELS
+    ToggleChannelMode();
+#endif
     break;
   case KEY_EXIT:
     if (menuState) {
@@ -1007,7 +1184,12 @@ static void RenderStatus() {
 
 static void RenderSpectrum() {
   DrawTicks();
-  DrawArrow(128u * peak.i / GetStepsCount());
+#ifdef ENABLE_SPECTRUM_CHANNELS
+  if (channelMode)
+    DrawArrow(ChannelBarX(peak.i) + channelBarWidth / 2);
+  else
+#endif
+    DrawArrow(128u * peak.i / GetStepsCount());
   DrawSpectrum();
   DrawRssiTriggerLevel();
   DrawF(peak.f);
@@ -1038,9 +1220,12 @@ static void RenderStill() {
 
   int dbm = Rssi2DBm(scanInfo.rssi);
   uint8_t s = DBm2S(dbm);
-  sprintf(String, "S: %u", s);
+  String[0] = 'S';
+  String[1] = ':';
+  String[2] = ' ';
+  FORMAT_Unsigned(String + 3, s, 0, ' ');
   GUI_DisplaySmallest(String, 4, 25, false, true);
-  sprintf(String, "%d dBm", dbm);
+  FORMAT_Dbm(String, dbm);
   GUI_DisplaySmallest(String, 28, 25, false, true);
 
   if (!monitorMode) {
@@ -1068,7 +1253,7 @@ static void RenderStill() {
     sprintf(String, "%s", registerSpecs[idx].name);
     GUI_DisplaySmallest(String, offset + 2, row * 8 + 2, false,
                         menuState != idx);
-    sprintf(String, "%u", GetRegMenuValue(idx));
+    FORMAT_Unsigned(String, GetRegMenuValue(idx), 0, ' ');
     GUI_DisplaySmallest(String, offset + 2, (row + 1) * 8 + 1, false,
                         menuState != idx);
   }
@@ -1138,13 +1323,28 @@ static void Scan() {
 static void NextScanStep() {
   ++peak.t;
   ++scanInfo.i;
+#ifdef ENABLE_SPECTRUM_CHANNELS
+  if (channelMode) {
+    scanInfo.f = channelFreqs[scanInfo.i];
+    return;
+  }
+#endif
   scanInfo.f += scanInfo.scanStep;
 }
 
+static bool IsLastScanStep() {
+#ifdef ENABLE_SPECTRUM_CHANNELS
+  // a range sweep measures both of its edges, a channel list has no extra point
+  if (channelMode)
+    return scanInfo.i + 1 >= scanInfo.measurementsCount;
+#endif
+  return scanInfo.i >= scanInfo.measurementsCount;
+}
+
 static void UpdateScan() {
   Scan();
 
-  if (scanInfo.i < scanInfo.measurementsCount) {
+  if (!IsLastScanStep()) {
     NextScanStep();
     return;
   }
@@ -1209,12 +1409,17 @@ static void UpdateListening() {
 }
 
 static void Tick() {
-#ifdef ENABLE_AM_FIX
+#if defined(ENABLE_AM_FIX) || defined(ENABLE_RSSI_TRACE)
   if (gNextTimeslice) {
     gNextTimeslice = false;
+#ifdef ENABLE_RSSI_TRACE
+    RSSI_TRACE_TimeSlice10ms();
+#endif
+#ifdef ENABLE_AM_FIX
     if(settings.modulationType == MODULATION_AM && !lockAGC) {
       AM_fix_10ms(vfo); //allow AM_Fix to apply its AGC action
     }
+#endif
   }
 #endif
 
@@ -1266,6 +1471,14 @@ static void Tick() {
 }
 
 void APP_RunSpectrum() {
+  // the sweep is paced by the core, run it at full speed
+  SYSTEM_SetClock(SYSTEM_CLOCK_48MHZ);
+
+#ifdef ENABLE_SPECTRUM_CHANNELS
+  // always start on frequencies, the channel table is reloaded when asked for
+  channelMode = false;
+#endif
+
   // TX here coz it always? set to active VFO
   vfo = gEeprom.TX_VFO;
   // set the current frequency in the middle of the display
@@ -22,6 +22,9 @@
 #ifdef ENABLE_FMRADIO
 	#include "app/fm.h"
 #endif
+#ifdef ENABLE_CHANNEL_STATS
+	#include "app/chstats.h"
+#endif
 #include "app/uart.h"
 #include "board.h"
 #include "bsp/dp32g030/dma.h"
@@ -34,7 +37,16 @@
 #include "driver/gpio.h"
 #include "driver/uart.h"
 #include "functions.h"
+#include "helper/battery.h"
+#ifdef ENABLE_PROFILING
+	#include "helper/profile.h"
+#endif
+#include "helper/rssi.h"
+#ifdef ENABLE_RSSI_TRACE
+	#include "helper/rssi_trace.h"
+#endif
 #include "misc.h"
+#include "radio.h"
 #include "settings.h"
 #include "version.h"
 
@@ -293,6 +305,8 @@ static void CMD_051D(const uint8_t *pBuffer)
 	gSerialConfigCountDown_500ms = 12; // 6 sec
 	
 	bReloadEeprom = false;
+	bool bNamesChanged = false;
+	bool bCalibrationChanged = false;
 
 	#ifdef ENABLE_FMRADIO
 		gFmRadioCountdown_500ms = fm_radio_countdown_500ms;
@@ -315,10 +329,22 @@ static void CMD_051D(const uint8_t *pBuffer)
 				if (!gIsLocked)
 					bReloadEeprom = true;
 
+			if (Offset >= 0x0F50 && Offset < 0x1C00)
+				bNamesChanged = true;
+
+			if (Offset >= 0x1E00 && Offset < 0x1F40)
+				bCalibrationChanged = true;
+
 			if ((Offset < 0x0E98 || Offset >= 0x0EA0) || !bIsInLockScreen || pCmd->bAllowPassword)
 				EEPROM_WriteBuffer(Offset, &pCmd->Data[i * 8U]);
 		}
 
+		if (bNamesChanged)
+			SETTINGS_InvalidateChannelNameCache(-1);
+
+		if (bCalibrationChanged)
+			RADIO_InvalidateCalibrationCache();
+
 		if (bReloadEeprom)
 			SETTINGS_InitEEPROM();
 	}
@@ -329,13 +355,14 @@ static void CMD_051D(const uint8_t *pBuffer)
 // read RSSI
 static void CMD_0527(void)
 {
-	REPLY_0527_t Reply;
+	REPLY_0527_t         Reply;
+	const RSSI_Sample_t *pSample = RSSI_Get();
 
 	Reply.Header.ID             = 0x0528;
 	Reply.Header.Size           = sizeof(Reply.Data);
-	Reply.Data.RSSI             = BK4819_ReadRegister(BK4819_REG_67) & 0x01FF;
-	Reply.Data.ExNoiseIndicator = BK4819_ReadRegister(BK4819_REG_65) & 0x007F;
-	Reply.Data.GlitchIndicator  = BK4819_ReadRegister(BK4819_REG_63);
+	Reply.Data.RSSI             = pSample->Rssi;
+	Reply.Data.ExNoiseIndicator = pSample->ExNoise;
+	Reply.Data.GlitchIndicator  = pSample->Glitch;
 
 	SendReply(&Reply, sizeof(Reply));
 }
@@ -350,6 +377,7 @@ static void CMD_0529(void)
 
 	// Original doesn't actually send current!
 	BOARD_ADC_GetBatteryInfo(&Reply.Data.Voltage, &Reply.Data.Current);
+	Reply.Data.Voltage = BATTERY_GetFilteredVoltage();
 
 	SendReply(&Reply, sizeof(Reply));
 }
@@ -472,6 +500,179 @@ static void CMD_0602_WriteBK4819Reg(const uint8_t *pBuffer)
 }
 #endif
 
+#ifdef ENABLE_RSSI_TRACE
+// set trace mode: 0 = off, 1 = capture, 2 = replay
+// replies with the resulting mode and the number of entries held
+static void CMD_0603_SetRssiTraceMode(const uint8_t *pBuffer)
+{
+	typedef struct __attribute__((__packed__)) {
+		Header_t header;
+		uint8_t mode;
+	} CMD_0603_t;
+
+	CMD_0603_t *cmd = (CMD_0603_t*) pBuffer;
+
+	struct __attribute__((__packed__)) {
+		Header_t header;
+		struct __attribute__((__packed__)) {
+			uint8_t mode;
+			uint8_t count;
+		} data;
+	} reply;
+
+	if (cmd->mode <= RSSI_TRACE_REPLAY)
+		RSSI_TRACE_SetMode(cmd->mode);
+
+	reply.header.ID = 0x0603;
+	reply.header.Size = sizeof(reply.data);
+	reply.data.mode = RSSI_TRACE_GetMode();
+	reply.data.count = gRssiTraceCount;
+	SendReply(&reply, sizeof(reply));
+}
+
+// read up to 8 trace entries, oldest first
+static void CMD_0604_ReadRssiTrace(const uint8_t *pBuffer)
+{
+	typedef struct __attribute__((__packed__)) {
+		Header_t header;
+		uint8_t index;
+		uint8_t count;
+	} CMD_0604_t;
+
+	CMD_0604_t *cmd = (CMD_0604_t*) pBuffer;
+
+	struct __attribute__((__packed__)) {
+		Header_t header;
+		struct __attribute__((__packed__)) {
+			uint8_t index;
+			uint8_t count;
+			RSSI_TRACE_Entry_t entries[8];
+		} data;
+	} reply;
+
+	uint8_t count = 0;
+	while (count < cmd->count && count < ARRAY_SIZE(reply.data.entries) && cmd->index + count < gRssiTraceCount) {
+		reply.data.entries[count] = *RSSI_TRACE_GetEntry(cmd->index + count);
+		count++;
+	}
+
+	reply.header.ID = 0x0604;
+	reply.header.Size = 2 + count * sizeof(RSSI_TRACE_Entry_t);
+	reply.data.index = cmd->index;
+	reply.data.count = count;
+	SendReply(&reply, sizeof(Header_t) + reply.header.Size);
+}
+
+// load up to 8 trace entries for replay, index 0 starts a new trace
+// replies with the number of entries taken and the number now held
+static void CMD_0605_WriteRssiTrace(const uint8_t *pBuffer)
+{
+	typedef struct __attribute__((__packed__)) {
+		Header_t header;
+		uint8_t index;
+		uint8_t count;
+		RSSI_TRACE_Entry_t entries[8];
+	} CMD_0605_t;
+
+	CMD_0605_t *cmd = (CMD_0605_t*) pBuffer;
+
+	struct __attribute__((__packed__)) {
+		Header_t header;
+		struct __attribute__((__packed__)) {
+			uint8_t index;
+			uint8_t count;
+			uint8_t total;
+		} data;
+	} reply;
+
+	uint8_t count = 0;
+	while (count < cmd->count && count < ARRAY_SIZE(cmd->entries) && cmd->index + count < RSSI_TRACE_SIZE) {
+		RSSI_TRACE_Entry_t entry;
+		memcpy(&entry, &cmd->entries[count], sizeof(entry));
+		RSSI_TRACE_LoadEntry(cmd->index + count, &entry);
+		count++;
+	}
+
+	reply.header.ID = 0x0605;
+	reply.header.Size = sizeof(reply.data);
+	reply.data.index = cmd->index;
+	reply.data.count = count;
+	reply.data.total = gRssiTraceCount;
+	SendReply(&reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_PROFILING
+static void CMD_0606_ReadProfileCounters(void)
+{
+	struct __attribute__((__packed__)) {
+		Header_t header;
+		struct __attribute__((__packed__)) {
+			uint8_t count;
+			uint32_t counters[PROFILE_N_ELEM];
+		} data;
+	} reply;
+
+	reply.header.ID = 0x0606;
+	reply.header.Size = sizeof(reply.data);
+	reply.data.count = PROFILE_N_ELEM;
+	memcpy(reply.data.counters, gProfileCounters, sizeof(reply.data.counters));
+	SendReply(&reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_CHANNEL_STATS
+// up to 8 channels in activity order, starting at the given rank
+static void CMD_0607_ReadChannelStats(const uint8_t *pBuffer)
+{
+	typedef struct __attribute__((__packed__)) {
+		Header_t header;
+		uint8_t rank;
+		uint8_t count;
+	} CMD_0607_t;
+
+	CMD_0607_t *cmd = (CMD_0607_t*) pBuffer;
+
+	typedef struct __attribute__((__packed__)) {
+		uint8_t channel;
+		uint8_t peakRssi;
+		uint16_t hits;
+		uint32_t openTime_10ms;
+		uint32_t lastHeardAgo_10ms;   // 0 = never heard
+	} Entry_t;
+
+	struct __attribute__((__packed__)) {
+		Header_t header;
+		struct __attribute__((__packed__)) {
+			uint8_t rank;
+			uint8_t count;
+			Entry_t entries[8];
+		} data;
+	} reply;
+
+	uint8_t count = 0;
+	while (count < cmd->count && count < ARRAY_SIZE(reply.data.entries) && cmd->rank + count < ARRAY_SIZE(gChannelStatsOrder)) {
+		const uint8_t channel = gChannelStatsOrder[cmd->rank + count];
+		const CHSTATS_Channel_t *pStats = &gChannelStats[channel];
+		if (pStats->Hits == 0)
+			break;
+
+		Entry_t *pEntry = &reply.data.entries[count++];
+		pEntry->channel = channel;
+		pEntry->peakRssi = pStats->PeakRssi;
+		pEntry->hits = pStats->Hits;
+		pEntry->openTime_10ms = pStats->OpenTime_10ms;
+		pEntry->lastHeardAgo_10ms = pStats->LastHeard_10ms ? CHSTATS_GetTick() - pStats->LastHeard_10ms + 1 : 0;
+	}
+
+	reply.header.ID = 0x0607;
+	reply.header.Size = 2 + count * sizeof(Entry_t);
+	reply.data.rank = cmd->rank;
+	reply.data.count = count;
+	SendReply(&reply, sizeof(Header_t) + reply.header.Size);
+}
+#endif
+
 bool UART_IsCommandAvailable(void)
 {
 	uint16_t Index;
@@ -620,5 +821,31 @@ void UART_HandleCommand(void)
 			CMD_0602_WriteBK4819Reg(UART_Command.Buffer);
 			break;
 #endif
+
+#ifdef ENABLE_RSSI_TRACE
+		case 0x0603:
+			CMD_0603_SetRssiTraceMode(UART_Command.Buffer);
+			break;
+
+		case 0x0604:
+			CMD_0604_ReadRssiTrace(UART_Command.Buffer);
+			break;
+
+		case 0x0605:
+			CMD_0605_WriteRssiTrace(UART_Command.Buffer);
+			break;
+#endif
+
+#ifdef ENABLE_PROFILING
+		case 0x0606:
+			CMD_0606_ReadProfileCounters();
+			break;
+#endif
+
+#ifdef ENABLE_CHANNEL_STATS
+		case 0x0607:
+			CMD_0607_ReadChannelStats(UART_Command.Buffer);
+			break;
+#endif
 	}
 }
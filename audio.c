@@ -14,6 +14,8 @@
  *     limitations under the License.
  */
 
+#include <stddef.h>
+
 #ifdef ENABLE_FMRADIO
 	#include "app/fm.h"
 #endif
@@ -34,6 +36,256 @@
 
 BEEP_Type_t gBeepToPlay = BEEP_NONE;
 
+static const AUDIO_ToneStep_t *gToneStep;   // NULL when idle
+static uint8_t                 gToneWait_10ms;
+static uint16_t                gToneFrequency;
+static void                  (*gToneDone)(void);
+static void                  (*gToneIdle)(void);
+static bool                    gToneDraining;   // idle callbacks wait for a script that runs to its end
+static BEEP_Type_t             gBeepQueued = BEEP_NONE;
+
+static uint16_t                gBeepToneConfig;
+
+// the sub 10ms settling delays are rounded up to a tick
+#define BEEP_START \
+	{ AUDIO_TONE_PATH_OFF, 2, 0 }, \
+	{ AUDIO_TONE_BEEP,     1, 0 }, \
+	{ AUDIO_TONE_PATH_ON,  6, 0 }
+#define BEEP_PULSE \
+	{ AUDIO_TONE_UNMUTE,   6, 0 }, \
+	{ AUDIO_TONE_MUTE,     2, 0 }
+#define BEEP_LAST(duration_10ms) \
+	{ AUDIO_TONE_UNMUTE,   duration_10ms, 0 }, \
+	{ AUDIO_TONE_MUTE,     2, 0 }, \
+	{ AUDIO_TONE_PATH_OFF, 1, 0 }, \
+	{ AUDIO_TONE_RX,       1, 0 }, \
+	{ AUDIO_TONE_END,      0, 0 }
+
+static const AUDIO_ToneStep_t Beep40ms[]    = { BEEP_START, BEEP_LAST(4) };
+static const AUDIO_ToneStep_t Beep60ms[]    = { BEEP_START, BEEP_LAST(6) };
+static const AUDIO_ToneStep_t Beep200ms[]   = { BEEP_START, BEEP_LAST(20) };
+static const AUDIO_ToneStep_t Beep500ms[]   = { BEEP_START, BEEP_LAST(50) };
+static const AUDIO_ToneStep_t BeepDouble[]  = { BEEP_START, BEEP_PULSE, BEEP_LAST(6) };
+static const AUDIO_ToneStep_t BeepTriple[]  = { BEEP_START, BEEP_PULSE, BEEP_PULSE, BEEP_LAST(6) };
+
+// motorola type
+static const AUDIO_ToneStep_t RogerNormal[] = {
+	{ AUDIO_TONE_TX,       5, 66 },
+	{ AUDIO_TONE_FREQ,     0, 1540 },
+	{ AUDIO_TONE_UNMUTE,   8, 0 },
+	{ AUDIO_TONE_MUTE,     0, 0 },
+	{ AUDIO_TONE_FREQ,     0, 1310 },
+	{ AUDIO_TONE_UNMUTE,   8, 0 },
+	{ AUDIO_TONE_MUTE,     0, 0 },
+	{ AUDIO_TONE_TX_OFF,   0, 0 },
+	{ AUDIO_TONE_END,      0, 0 }
+};
+
+static const AUDIO_ToneStep_t RogerMDC[] = {
+	{ AUDIO_TONE_MDC_LOAD, 2, 0 },
+	{ AUDIO_TONE_MDC_SEND, 18, 0 },
+	{ AUDIO_TONE_MDC_STOP, 0, 0 },
+	{ AUDIO_TONE_END,      0, 0 }
+};
+
+static void FinishTones(void)
+{
+	void (*pDone)(void) = gToneDone;
+	BEEP_Type_t Beep    = gBeepQueued;
+
+	// taken before the done chain, it may well reset the chip through AUDIO_StopTone
+	gBeepQueued    = BEEP_NONE;
+	gToneStep      = NULL;
+	gToneDone      = NULL;
+	gToneWait_10ms = 0;
+
+	if (pDone != NULL)
+		pDone();
+
+	if (gToneIdle != NULL && gToneStep == NULL && !gToneDraining) {
+		void (*pIdle)(void) = gToneIdle;
+		gToneIdle = NULL;
+		pIdle();
+	}
+
+	if (gBeepQueued != BEEP_NONE)
+		Beep = gBeepQueued;   // queued by the done chain, the newest one wins
+
+	gBeepQueued = BEEP_NONE;
+
+	if (Beep != BEEP_NONE) {
+		if (gToneStep == NULL)
+			AUDIO_PlayBeep(Beep);
+		else
+			gBeepQueued = Beep;
+	}
+}
+
+// run the steps up to the next wait, or all of them when stopping
+static void RunToneSteps(const bool bSkipWaits)
+{
+	while (gToneStep != NULL && (gToneWait_10ms == 0 || bSkipWaits)) {
+		const AUDIO_ToneStep_t *pStep = gToneStep++;
+		const uint16_t          Value = pStep->Value;
+
+		switch (pStep->Op) {
+			case AUDIO_TONE_END:
+				FinishTones();
+				return;
+			case AUDIO_TONE_WAIT:
+				break;
+			case AUDIO_TONE_PATH_OFF:
+				AUDIO_AudioPathOff();
+				break;
+			case AUDIO_TONE_PATH_ON:
+				AUDIO_AudioPathOn();
+				break;
+			case AUDIO_TONE_BEEP:
+				BK4819_PlayTone(Value ? Value : gToneFrequency, true);
+				break;
+			case AUDIO_TONE_TX:
+				BK4819_StartTone1(Value, false);
+				break;
+			case AUDIO_TONE_FREQ:
+				BK4819_SetToneFrequency(Value ? Value : gToneFrequency);
+				break;
+			case AUDIO_TONE_UNMUTE:
+				BK4819_ExitTxMute();
+				break;
+			case AUDIO_TONE_MUTE:
+				BK4819_EnterTxMute();
+				break;
+			case AUDIO_TONE_TX_OFF:
+				BK4819_StopTone1();
+				break;
+			case AUDIO_TONE_RX:
+				BK4819_TurnsOffTones_TurnsOnRX();
+				break;
+			case AUDIO_TONE_MDC_LOAD:
+				BK4819_LoadRogerMDC();
+				break;
+			case AUDIO_TONE_MDC_SEND:
+				BK4819_SendRogerMDC();
+				break;
+			case AUDIO_TONE_MDC_STOP:
+				BK4819_StopRogerMDC();
+				break;
+			case AUDIO_TONE_AF:
+				BK4819_SetAF(Value);
+				break;
+			case AUDIO_TONE_DTMF_ENTER:
+				BK4819_EnterDTMF_TX(Value);
+				break;
+			case AUDIO_TONE_DTMF_DIGIT:
+				BK4819_PlayDTMF(Value);
+				BK4819_ExitTxMute();
+				break;
+			case AUDIO_TONE_DTMF_EXIT:
+				BK4819_ExitDTMF_TX(Value);
+				break;
+			default:
+				break;
+		}
+
+		gToneWait_10ms = pStep->Wait_10ms;
+	}
+}
+
+void AUDIO_PlayTones(const AUDIO_ToneStep_t *pScript, const uint16_t Frequency, void (*pDone)(void))
+{
+	// the idle callback stays pending, it runs once the new script is done
+	gToneDraining = true;
+	while (gToneStep != NULL)
+		RunToneSteps(true);
+	gToneDraining = false;
+
+	gToneStep      = pScript;
+	gToneFrequency = Frequency;
+	gToneDone      = pDone;
+	gToneWait_10ms = 0;
+
+	RunToneSteps(false);
+}
+
+bool AUDIO_IsTonePlaying(void)
+{
+	return gToneStep != NULL;
+}
+
+// once the scripts, and whatever they chain on completion, are done
+void AUDIO_WhenToneDone(void (*pIdle)(void))
+{
+	if (gToneStep == NULL)
+		pIdle();
+	else
+		gToneIdle = pIdle;
+}
+
+// cut the script short, its remaining steps still leave the chip as it
+// expects and their done callbacks run, a queued beep and the idle callback
+// are dropped, returns true when there was one, the caller then restores
+// whatever it would have, e.g. drops the carrier of a DTMF reply
+bool AUDIO_StopTone(void)
+{
+	gBeepQueued   = BEEP_NONE;
+	gToneDraining = true;
+	while (gToneStep != NULL)
+		RunToneSteps(true);
+	gToneDraining = false;
+
+	const bool bDropped = gToneIdle != NULL;
+	gToneIdle = NULL;
+
+	return bDropped;
+}
+
+// for the few places that reconfigure the chip straight after a tone
+void AUDIO_WaitTone(void)
+{
+	while (gToneStep != NULL) {
+		SYSTEM_DelayMs(10);
+		AUDIO_ToneTick();
+	}
+}
+
+void AUDIO_ToneTick(void)
+{
+	if (gToneStep != NULL && gToneWait_10ms > 0 && --gToneWait_10ms == 0)
+		RunToneSteps(false);
+}
+
+bool AUDIO_PlayRoger(void (*pDone)(void))
+{
+	if (gEeprom.ROGER == ROGER_MODE_ROGER)
+		AUDIO_PlayTones(RogerNormal, 0, pDone);
+	else if (gEeprom.ROGER == ROGER_MODE_MDC)
+		AUDIO_PlayTones(RogerMDC, 0, pDone);
+	else
+		return false;
+
+	return true;
+}
+
+static void BeepDone(void)
+{
+	BK4819_WriteRegister(BK4819_REG_71, gBeepToneConfig);
+
+	if (gEnableSpeaker)
+		AUDIO_AudioPathOn();
+
+#ifdef ENABLE_FMRADIO
+	if (gFmRadioMode)
+		BK1080_Mute(false);
+#endif
+
+	if (gCurrentFunction == FUNCTION_POWER_SAVE && gRxIdleMode)
+		BK4819_Sleep();
+
+#ifdef ENABLE_VOX
+	gVoxResumeCountdown = 80;
+#endif
+}
+
 void AUDIO_PlayBeep(BEEP_Type_t Beep)
 {
 
@@ -56,19 +308,21 @@ void AUDIO_PlayBeep(BEEP_Type_t Beep)
 	if (gCurrentFunction == FUNCTION_MONITOR)
 		return;
 
+	if (gToneStep != NULL) {
+		// after the one that's playing, e.g. the timeout beep after the roger
+		gBeepQueued = Beep;
+		return;
+	}
+
 #ifdef ENABLE_FMRADIO
 	if (gFmRadioMode)
 		BK1080_Mute(true);
 #endif
 
-	AUDIO_AudioPathOff();
-
 	if (gCurrentFunction == FUNCTION_POWER_SAVE && gRxIdleMode)
 		BK4819_RX_TurnOn();
 
-	SYSTEM_DelayMs(20);
-
-	uint16_t ToneConfig = BK4819_ReadRegister(BK4819_REG_71);
+	gBeepToneConfig = BK4819_ReadRegister(BK4819_REG_71);
 
 	uint16_t ToneFrequency;
 	switch (Beep)
@@ -96,77 +350,34 @@ void AUDIO_PlayBeep(BEEP_Type_t Beep)
 			break;
 	}
 
-	BK4819_PlayTone(ToneFrequency, true);
-
-	SYSTEM_DelayMs(2);
-
-	AUDIO_AudioPathOn();
-
-	SYSTEM_DelayMs(60);
-
-	uint16_t Duration;
+	const AUDIO_ToneStep_t *pScript;
 	switch (Beep)
 	{
 		case BEEP_880HZ_60MS_TRIPLE_BEEP:
-			BK4819_ExitTxMute();
-			SYSTEM_DelayMs(60);
-			BK4819_EnterTxMute();
-			SYSTEM_DelayMs(20);
-			[[fallthrough]];
+			pScript = BeepTriple;
+			break;
 		case BEEP_500HZ_60MS_DOUBLE_BEEP_OPTIONAL:
 		case BEEP_500HZ_60MS_DOUBLE_BEEP:
-			BK4819_ExitTxMute();
-			SYSTEM_DelayMs(60);
-			BK4819_EnterTxMute();
-			SYSTEM_DelayMs(20);
-			[[fallthrough]];
+			pScript = BeepDouble;
+			break;
 		case BEEP_1KHZ_60MS_OPTIONAL:
-			BK4819_ExitTxMute();
-			Duration = 60;
+			pScript = Beep60ms;
 			break;
 		case BEEP_880HZ_40MS_OPTIONAL:
 		case BEEP_440HZ_40MS_OPTIONAL:
-			BK4819_ExitTxMute();
-			Duration = 40;
+			pScript = Beep40ms;
 			break;
 		case BEEP_880HZ_200MS:
-			BK4819_ExitTxMute();
-			Duration = 200;
+			pScript = Beep200ms;
 			break;
 		case BEEP_440HZ_500MS:
 		case BEEP_880HZ_500MS:
 		default:
-			BK4819_ExitTxMute();
-			Duration = 500;
+			pScript = Beep500ms;
 			break;
 	}
 
-	SYSTEM_DelayMs(Duration);
-	BK4819_EnterTxMute();
-	SYSTEM_DelayMs(20);
-
-	AUDIO_AudioPathOff();
-
-	SYSTEM_DelayMs(5);
-	BK4819_TurnsOffTones_TurnsOnRX();
-	SYSTEM_DelayMs(5);
-	BK4819_WriteRegister(BK4819_REG_71, ToneConfig);
-
-	if (gEnableSpeaker)
-		AUDIO_AudioPathOn();
-
-#ifdef ENABLE_FMRADIO
-	if (gFmRadioMode)
-		BK1080_Mute(false);
-#endif
-
-	if (gCurrentFunction == FUNCTION_POWER_SAVE && gRxIdleMode)
-		BK4819_Sleep();
-
-#ifdef ENABLE_VOX
-	gVoxResumeCountdown = 80;
-#endif
-
+	AUDIO_PlayTones(pScript, ToneFrequency, BeepDone);
 }
 
 #ifdef ENABLE_VOICE
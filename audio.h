@@ -41,7 +41,43 @@ typedef enum BEEP_Type_t BEEP_Type_t;
 
 extern BEEP_Type_t       gBeepToPlay;
 
+// tone scripts are run from the 10ms timeslice, each step waits Wait_10ms
+// before the next one runs
+typedef enum {
+	AUDIO_TONE_END = 0,
+	AUDIO_TONE_WAIT,
+	AUDIO_TONE_PATH_OFF,   // speaker amplifier
+	AUDIO_TONE_PATH_ON,
+	AUDIO_TONE_BEEP,       // tone to the speaker at Value Hz, still muted
+	AUDIO_TONE_TX,         // tone to the modulator at level Value, still muted
+	AUDIO_TONE_FREQ,       // Value Hz
+	AUDIO_TONE_UNMUTE,
+	AUDIO_TONE_MUTE,
+	AUDIO_TONE_TX_OFF,     // tone off, TX audio back
+	AUDIO_TONE_RX,         // tones off, RX back on
+	AUDIO_TONE_MDC_LOAD,
+	AUDIO_TONE_MDC_SEND,
+	AUDIO_TONE_MDC_STOP,
+	AUDIO_TONE_AF,         // Value = BK4819_AF_Type_t
+	AUDIO_TONE_DTMF_ENTER, // Value = side tone
+	AUDIO_TONE_DTMF_DIGIT, // Value = character, unmuted
+	AUDIO_TONE_DTMF_EXIT   // Value = stay muted
+} AUDIO_ToneOp_t;
+
+typedef struct {
+	uint8_t  Op;
+	uint8_t  Wait_10ms;
+	uint16_t Value;        // BEEP and FREQ: 0 = the frequency the script was started with
+} AUDIO_ToneStep_t;
+
 void AUDIO_PlayBeep(BEEP_Type_t Beep);
+void AUDIO_PlayTones(const AUDIO_ToneStep_t *pScript, const uint16_t Frequency, void (*pDone)(void));
+bool AUDIO_PlayRoger(void (*pDone)(void));
+bool AUDIO_IsTonePlaying(void);
+void AUDIO_WhenToneDone(void (*pIdle)(void));
+bool AUDIO_StopTone(void);
+void AUDIO_WaitTone(void);
+void AUDIO_ToneTick(void);
 
 enum
 {
@@ -461,7 +461,7 @@ void BOARD_ADC_Init(void)
 	Config.CLK_SEL            = SYSCON_CLK_SEL_W_SARADC_SMPL_VALUE_DIV2;
 	Config.CH_SEL             = ADC_CH4 | ADC_CH9;
 	Config.AVG                = SARADC_CFG_AVG_VALUE_8_SAMPLE;
-	Config.CONT               = SARADC_CFG_CONT_VALUE_SINGLE;
+	Config.CONT               = SARADC_CFG_CONT_VALUE_CONTINUOUS;
 	Config.MEM_MODE           = SARADC_CFG_MEM_MODE_VALUE_CHANNEL;
 	Config.SMPL_CLK           = SARADC_CFG_SMPL_CLK_VALUE_INTERNAL;
 	Config.SMPL_WIN           = SARADC_CFG_SMPL_WIN_VALUE_15_CYCLE;
@@ -477,12 +477,15 @@ void BOARD_ADC_Init(void)
 	ADC_Configure(&Config);
 	ADC_Enable();
 	ADC_SoftReset();
+
+	// converts on its own from now on, the channel registers always hold
+	// the latest result
+	ADC_Start();
+	while (!ADC_CheckEndOfConversion(ADC_CH9)) {}
 }
 
 void BOARD_ADC_GetBatteryInfo(uint16_t *pVoltage, uint16_t *pCurrent)
 {
-	ADC_Start();
-	while (!ADC_CheckEndOfConversion(ADC_CH9)) {}
 	*pVoltage = ADC_GetValue(ADC_CH4);
 	*pCurrent = ADC_GetValue(ADC_CH9);
 }
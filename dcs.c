@@ -66,6 +66,26 @@ uint32_t DCS_GetGolayCodeWord(DCS_CodeType_t CodeType, uint8_t Option)
 	return Code;
 }
 
+// DCS_Options is sorted, a binary search keeps the 23 rotations cheap
+static int DCS_FindOption(uint16_t Code)
+{
+	int Low  = 0;
+	int High = ARRAY_SIZE(DCS_Options) - 1;
+
+	while (Low <= High)
+	{
+		const int Mid = (Low + High) / 2;
+		if (DCS_Options[Mid] == Code)
+			return Mid;
+		if (DCS_Options[Mid] < Code)
+			Low = Mid + 1;
+		else
+			High = Mid - 1;
+	}
+
+	return -1;
+}
+
 uint8_t DCS_GetCdcssCode(uint32_t Code)
 {
 	unsigned int i;
@@ -75,11 +95,9 @@ uint8_t DCS_GetCdcssCode(uint32_t Code)
 
 		if (((Code >> 9) & 0x7U) == 4)
 		{
-			unsigned int j;
-			for (j = 0; j < ARRAY_SIZE(DCS_Options); j++)
-				if (DCS_Options[j] == (Code & 0x1FF))
-					if (DCS_GetGolayCodeWord(2, j) == Code)
-						return j;
+			const int j = DCS_FindOption(Code & 0x1FF);
+			if (j >= 0 && DCS_GetGolayCodeWord(CODE_TYPE_DIGITAL, j) == Code)
+				return j;
 		}
 
 		Shift = Code >> 1;
@@ -25,10 +25,11 @@
 uint16_t gBacklightCountdown_500ms = 0;
 bool backlightOn;
 
+static const uint32_t PWM_FREQUENCY_HZ = 1000;
+
 void BACKLIGHT_InitHardware()
 {
 	// 48MHz / 94 / 1024 ~ 500Hz
-	const uint32_t PWM_FREQUENCY_HZ =  1000;
 	PWM_PLUS0_CLKSRC |= ((48000000 / 1024 / PWM_FREQUENCY_HZ) << 16);
 	PWM_PLUS0_PERIOD = 1023;
 
@@ -115,4 +116,10 @@ void BACKLIGHT_SetBrightness(uint8_t brigtness)
 uint8_t BACKLIGHT_GetBrightness(void)
 {
 	return currentBrightness;
-}
\ No newline at end of file
+}
+
+// the PWM counts core clocks, rescale its prescaler so the dimming doesn't flicker
+void BACKLIGHT_SetClockShift(uint8_t Shift)
+{
+	PWM_PLUS0_CLKSRC = (PWM_PLUS0_CLKSRC & 0xFFFFU) | (((48000000U >> Shift) / 1024 / PWM_FREQUENCY_HZ) << 16);
+}
@@ -37,5 +37,6 @@ void BACKLIGHT_TurnOff();
 bool BACKLIGHT_IsOn();
 void BACKLIGHT_SetBrightness(uint8_t brigtness);
 uint8_t BACKLIGHT_GetBrightness(void);
+void BACKLIGHT_SetClockShift(uint8_t Shift);
 
 #endif
@@ -19,6 +19,7 @@
 #include "driver/gpio.h"
 #include "driver/i2c.h"
 #include "driver/system.h"
+#include "helper/task.h"
 #include "misc.h"
 
 #ifndef ARRAY_SIZE
@@ -36,9 +37,34 @@ static const uint16_t BK1080_RegisterTable[] =
 
 static bool gIsInitBK1080;
 
+// tuned to once the power up is done
+static uint16_t gPowerUpFrequency;
+static uint8_t  gPowerUpBand;
+
 uint16_t BK1080_BaseFrequency;
 uint16_t BK1080_FrequencyDeviation;
 
+// the chip takes 300ms to settle after the register table, the main loop
+// carries on meanwhile
+static bool BK1080_PowerUpTask(TASK_Context_t *pTask)
+{
+	TASK_BEGIN(pTask);
+
+	TASK_YIELD_FOR(pTask, 250);
+
+	BK1080_WriteRegister(BK1080_REG_25_INTERNAL, 0xA83C);
+	BK1080_WriteRegister(BK1080_REG_25_INTERNAL, 0xA8BC);
+
+	TASK_YIELD_FOR(pTask, 60);
+
+	gIsInitBK1080 = true;
+
+	BK1080_WriteRegister(BK1080_REG_05_SYSTEM_CONFIGURATION2, 0x0A1F);
+	BK1080_SetFrequency(gPowerUpFrequency, gPowerUpBand);
+
+	TASK_END(pTask);
+}
+
 void BK1080_Init0(void)
 {
 	BK1080_Init(0,0/*,0*/);
@@ -52,26 +78,24 @@ void BK1080_Init(uint16_t freq, uint8_t band/*, uint8_t space*/)
 		GPIO_ClearBit(&GPIOB->DATA, GPIOB_PIN_BK1080);
 
 		if (!gIsInitBK1080) {
-			for (i = 0; i < ARRAY_SIZE(BK1080_RegisterTable); i++)
-				BK1080_WriteRegister(i, BK1080_RegisterTable[i]);
-
-			SYSTEM_DelayMs(250);
+			gPowerUpFrequency = freq;
+			gPowerUpBand      = band;
 
-			BK1080_WriteRegister(BK1080_REG_25_INTERNAL, 0xA83C);
-			BK1080_WriteRegister(BK1080_REG_25_INTERNAL, 0xA8BC);
+			if (!TASK_IsRunning(BK1080_PowerUpTask)) {
+				for (i = 0; i < ARRAY_SIZE(BK1080_RegisterTable); i++)
+					BK1080_WriteRegister(i, BK1080_RegisterTable[i]);
 
-			SYSTEM_DelayMs(60);
-
-			gIsInitBK1080 = true;
-		}
-		else {
-			BK1080_WriteRegister(BK1080_REG_02_POWER_CONFIGURATION, 0x0201);
+				TASK_Start(BK1080_PowerUpTask);
+			}
+			return;
 		}
 
+		BK1080_WriteRegister(BK1080_REG_02_POWER_CONFIGURATION, 0x0201);
 		BK1080_WriteRegister(BK1080_REG_05_SYSTEM_CONFIGURATION2, 0x0A1F);
 		BK1080_SetFrequency(freq, band/*, space*/);
 	}
 	else {
+		TASK_Stop(BK1080_PowerUpTask);
 		BK1080_WriteRegister(BK1080_REG_02_POWER_CONFIGURATION, 0x0241);
 		GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_BK1080);
 	}
@@ -102,11 +126,21 @@ void BK1080_WriteRegister(BK1080_Register_t Register, uint16_t Value)
 
 void BK1080_Mute(bool Mute)
 {
+	if (!gIsInitBK1080)
+		return;   // still powering up, it comes up unmuted
+
 	BK1080_WriteRegister(BK1080_REG_02_POWER_CONFIGURATION, Mute ? 0x4201 : 0x0201);
 }
 
 void BK1080_SetFrequency(uint16_t frequency, uint8_t band/*, uint8_t space*/)
 {
+	if (!gIsInitBK1080) {
+		// still powering up, tuned to once it's done
+		gPowerUpFrequency = frequency;
+		gPowerUpBand      = band;
+		return;
+	}
+
 	//uint8_t spacings[] = {20,10,5};
 	//space %= 3;
 
@@ -123,9 +157,18 @@ void BK1080_SetFrequency(uint16_t frequency, uint8_t band/*, uint8_t space*/)
 	BK1080_WriteRegister(BK1080_REG_03_CHANNEL, channel | 0x8000);
 }
 
+bool BK1080_IsReady(void)
+{
+	return gIsInitBK1080;
+}
+
 void BK1080_GetFrequencyDeviation(uint16_t Frequency)
 {
-	BK1080_BaseFrequency      = Frequency;
+	BK1080_BaseFrequency = Frequency;
+
+	if (!gIsInitBK1080)
+		return;   // still powering up, REG_07 reads garbage
+
 	BK1080_FrequencyDeviation = BK1080_ReadRegister(BK1080_REG_07) / 16;
 }
 
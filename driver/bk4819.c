@@ -27,6 +27,11 @@
 #include "gpio.h"
 #include "system.h"
 #include "systick.h"
+#include "../helper/rssi.h"
+
+#ifdef ENABLE_RSSI_TRACE
+	#include "../helper/rssi_trace.h"
+#endif
 
 
 #ifndef ARRAY_SIZE
@@ -40,6 +45,17 @@ static const uint8_t DTMF_TONE2_GAIN = 93;
 
 static uint16_t gBK4819_GpioOutState;
 
+// REG_3F as last written, no enabled source means no REG_0C polling
+static uint16_t gBK4819_InterruptMask;
+
+// latched interrupt events, single producer single consumer, so the
+// producer side could just as well run from an interrupt handler
+#define BK4819_EVENT_RING_SIZE 8   // power of 2
+
+static BK4819_Event_t   gBK4819_Events[BK4819_EVENT_RING_SIZE];
+static volatile uint8_t gBK4819_EventHead;   // written by the producer only
+static volatile uint8_t gBK4819_EventTail;   // written by the consumer only
+
 bool gRxIdleMode;
 
 __inline uint16_t scale_freq(const uint16_t freq)
@@ -167,11 +183,18 @@ uint16_t BK4819_ReadRegister(BK4819_REGISTER_t Register)
 	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
 	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SDA);
 
+#ifdef ENABLE_RSSI_TRACE
+	Value = RSSI_TRACE_FilterRegister(Register, Value);
+#endif
+
 	return Value;
 }
 
 void BK4819_WriteRegister(BK4819_REGISTER_t Register, uint16_t Data)
 {
+	if (Register == BK4819_REG_3F)
+		gBK4819_InterruptMask = Data;
+
 	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
 	GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
 
@@ -373,7 +396,7 @@ void BK4819_ToggleGpioOut(BK4819_GPIO_PIN_t Pin, bool bSet)
 	BK4819_WriteRegister(BK4819_REG_33, gBK4819_GpioOutState);
 }
 
-void BK4819_SetCDCSSCodeWord(uint32_t CodeWord)
+static uint16_t GetCDCSSConfig(void)
 {
 	// REG_51
 	//
@@ -420,7 +443,7 @@ void BK4819_SetCDCSSCodeWord(uint32_t CodeWord)
 	// Enable Auto CTCSS Bw Mode
 	// CTCSS/CDCSS Tx Gain1 Tuning = 51
 	//
-	BK4819_WriteRegister(BK4819_REG_51,
+	return
 		BK4819_REG_51_ENABLE_CxCSS         |
 		BK4819_REG_51_GPIO6_PIN2_NORMAL    |
 		BK4819_REG_51_TX_CDCSS_POSITIVE    |
@@ -429,7 +452,12 @@ void BK4819_SetCDCSSCodeWord(uint32_t CodeWord)
 		BK4819_REG_51_1050HZ_NO_DETECTION  |
 		BK4819_REG_51_AUTO_CDCSS_BW_ENABLE |
 		BK4819_REG_51_AUTO_CTCSS_BW_ENABLE |
-		(51u << BK4819_REG_51_SHIFT_CxCSS_TX_GAIN1));
+		(51u << BK4819_REG_51_SHIFT_CxCSS_TX_GAIN1);
+}
+
+void BK4819_SetCDCSSCodeWord(uint32_t CodeWord)
+{
+	BK4819_WriteRegister(BK4819_REG_51, GetCDCSSConfig());
 
 	// REG_07 <15:0>
 	//
@@ -458,7 +486,7 @@ void BK4819_SetCDCSSCodeWord(uint32_t CodeWord)
 	BK4819_WriteRegister(BK4819_REG_08, (1u << 15) | ((CodeWord >> 12) & 0x0FFF)); // MS 12-bits
 }
 
-void BK4819_SetCTCSSFrequency(uint32_t FreqControlWord)
+static uint16_t GetCTCSSConfig(uint32_t FreqControlWord)
 {
 	// REG_51 <15>  0                                 1 = Enable TxCTCSS/CDCSS           0 = Disable
 	// REG_51 <14>  0                                 1 = GPIO0Input for CDCSS           0 = Normal Mode.(for BK4819v3)
@@ -491,8 +519,11 @@ void BK4819_SetCTCSSFrequency(uint32_t FreqControlWord)
 		//
 		Config = 0x904A;   // 1 0 0 1 0 0 0 0 0 1001010
 	}
-	BK4819_WriteRegister(BK4819_REG_51, Config);
+	return Config;
+}
 
+static uint16_t GetCTCSSControlWord(uint32_t FreqControlWord)
+{
 	// REG_07 <15:0>
 	//
 	// When <13> = 0 for CTC1
@@ -510,7 +541,13 @@ void BK4819_SetCTCSSFrequency(uint32_t FreqControlWord)
 	//                          freq(Hz) * 20.64888 for XTAL 13M/26M or
 	//                          freq(Hz) * 20.97152 for XTAL 12.8M/19.2M/25.6M/38.4M
 	//
-	BK4819_WriteRegister(BK4819_REG_07, BK4819_REG_07_MODE_CTC1 | (((FreqControlWord * 206488u) + 50000u) / 100000u));   // with rounding
+	return BK4819_REG_07_MODE_CTC1 | (((FreqControlWord * 206488u) + 50000u) / 100000u);   // with rounding
+}
+
+void BK4819_SetCTCSSFrequency(uint32_t FreqControlWord)
+{
+	BK4819_WriteRegister(BK4819_REG_51, GetCTCSSConfig(FreqControlWord));
+	BK4819_WriteRegister(BK4819_REG_07, GetCTCSSControlWord(FreqControlWord));
 }
 
 // freq_10Hz is CTCSS Hz * 10
@@ -558,7 +595,7 @@ void BK4819_EnableVox(uint16_t VoxEnableThreshold, uint16_t VoxDisableThreshold)
 	BK4819_WriteRegister(BK4819_REG_31, REG_31_Value | (1u << 2));    // VOX Enable
 }
 
-void BK4819_SetFilterBandwidth(const BK4819_FilterBandwidth_t Bandwidth, const bool weak_no_different)
+static uint16_t GetFilterBandwidthReg(const BK4819_FilterBandwidth_t Bandwidth, const bool weak_no_different)
 {
 	// REG_43
 	// <15>    0 ???
@@ -660,10 +697,15 @@ void BK4819_SetFilterBandwidth(const BK4819_FilterBandwidth_t Bandwidth, const b
 			break;
 	}
 
-	BK4819_WriteRegister(BK4819_REG_43, val);
+	return val;
 }
 
-void BK4819_SetupPowerAmplifier(const uint8_t bias, const uint32_t frequency)
+void BK4819_SetFilterBandwidth(const BK4819_FilterBandwidth_t Bandwidth, const bool weak_no_different)
+{
+	BK4819_WriteRegister(BK4819_REG_43, GetFilterBandwidthReg(Bandwidth, weak_no_different));
+}
+
+static uint16_t GetPowerAmplifierReg(const uint8_t bias, const uint32_t frequency)
 {
 	// REG_36 <15:8> 0 PA Bias output 0 ~ 3.2V
 	//               255 = 3.2V
@@ -684,11 +726,21 @@ void BK4819_SetupPowerAmplifier(const uint8_t bias, const uint32_t frequency)
 	//                                  280MHz       g1=1  g2=0 (-14.9dBm),  g1=4  g2=2 (0.13dBm)
 	const uint8_t gain   = (frequency < 28000000) ? (1u << 3) | (0u << 0) : (4u << 3) | (2u << 0);
 	const uint8_t enable = 1;
-	BK4819_WriteRegister(BK4819_REG_36, (bias << 8) | (enable << 7) | (gain << 0));
+	return (bias << 8) | (enable << 7) | (gain << 0);
+}
+
+void BK4819_SetupPowerAmplifier(const uint8_t bias, const uint32_t frequency)
+{
+	BK4819_WriteRegister(BK4819_REG_36, GetPowerAmplifierReg(bias, frequency));
 }
 
 void BK4819_SetFrequency(uint32_t Frequency)
 {
+#ifdef ENABLE_RSSI_TRACE
+	RSSI_TRACE_SetFrequency(Frequency);
+#endif
+	RSSI_Invalidate();
+
 	BK4819_WriteRegister(BK4819_REG_38, (Frequency >>  0) & 0xFFFF);
 	BK4819_WriteRegister(BK4819_REG_39, (Frequency >> 16) & 0xFFFF);
 }
@@ -988,40 +1040,27 @@ void BK4819_PlayTone(uint16_t Frequency, bool bTuningGainSwitch)
 	BK4819_WriteRegister(BK4819_REG_71, scale_freq(Frequency));
 }
 
+// tone 1 onto the TX link, still muted, give it 50ms before unmuting
 // level 0 ~ 127
-void BK4819_PlaySingleTone(const unsigned int tone_Hz, const unsigned int delay, const unsigned int level, const bool play_speaker)
+void BK4819_StartTone1(const unsigned int level, const bool play_speaker)
 {
 	BK4819_EnterTxMute();
-
-	if (play_speaker)
-	{
-		AUDIO_AudioPathOn();
-		BK4819_SetAF(BK4819_AF_BEEP);
-	}
-	else
-		BK4819_SetAF(BK4819_AF_MUTE);
-
+	BK4819_SetAF(play_speaker ? BK4819_AF_BEEP : BK4819_AF_MUTE);
 
 	BK4819_WriteRegister(BK4819_REG_70, BK4819_REG_70_ENABLE_TONE1 | ((level & 0x7f) << BK4819_REG_70_SHIFT_TONE1_TUNING_GAIN));
 
 	BK4819_EnableTXLink();
-	SYSTEM_DelayMs(50);
+}
 
+void BK4819_SetToneFrequency(const uint16_t tone_Hz)
+{
 	BK4819_WriteRegister(BK4819_REG_71, scale_freq(tone_Hz));
+}
 
-	BK4819_ExitTxMute();
-	SYSTEM_DelayMs(delay);
-	BK4819_EnterTxMute();
-
-	if (play_speaker)
-	{
-		AUDIO_AudioPathOff();
-		BK4819_SetAF(BK4819_AF_MUTE);
-	}
-
+void BK4819_StopTone1(void)
+{
 	BK4819_WriteRegister(BK4819_REG_70, 0x0000);
-	BK4819_WriteRegister(BK4819_REG_30, 0xC1FE);
-	BK4819_ExitTxMute();
+	BK4819_WriteRegister(BK4819_REG_30, 0xC1FE);   // 1 1 0000 0 1 1111 1 1 1 0
 }
 
 void BK4819_EnterTxMute(void)
@@ -1125,6 +1164,45 @@ void BK4819_ExitBypass(void)
 	);
 }
 
+void BK4819_BuildTxImage(BK4819_TxImage_t *pImage, const uint32_t Frequency, const BK4819_FilterBandwidth_t Bandwidth, const bool weak_no_different, const uint8_t bias)
+{
+	pImage->Frequency = Frequency;
+	pImage->Reg43     = GetFilterBandwidthReg(Bandwidth, weak_no_different);
+	pImage->Reg36     = GetPowerAmplifierReg(bias, Frequency);
+	pImage->Reg51     = 0;   // CxCSS off
+}
+
+void BK4819_SetTxImageCTCSS(BK4819_TxImage_t *pImage, uint32_t FreqControlWord)
+{
+	pImage->Reg51 = GetCTCSSConfig(FreqControlWord);
+	pImage->Reg07 = GetCTCSSControlWord(FreqControlWord);
+}
+
+void BK4819_SetTxImageCDCSS(BK4819_TxImage_t *pImage, uint32_t CodeWord)
+{
+	pImage->Reg51    = GetCDCSSConfig();
+	pImage->Reg07    = BK4819_REG_07_MODE_CTC1 | 2775u;
+	pImage->Reg08[0] = (0u << 15) | ((CodeWord >>  0) & 0x0FFF);
+	pImage->Reg08[1] = (1u << 15) | ((CodeWord >> 12) & 0x0FFF);
+}
+
+// everything but the PA, which goes on once the PLL has locked
+void BK4819_WriteTxImage(const BK4819_TxImage_t *pImage)
+{
+	BK4819_WriteRegister(BK4819_REG_43, pImage->Reg43);
+	BK4819_SetFrequency(pImage->Frequency);
+
+	BK4819_WriteRegister(BK4819_REG_51, pImage->Reg51);
+	if (pImage->Reg51 != 0) {
+		BK4819_WriteRegister(BK4819_REG_07, pImage->Reg07);
+
+		if ((pImage->Reg51 & BK4819_REG_51_MODE_CTCSS) == 0) {
+			BK4819_WriteRegister(BK4819_REG_08, pImage->Reg08[0]);
+			BK4819_WriteRegister(BK4819_REG_08, pImage->Reg08[1]);
+		}
+	}
+}
+
 void BK4819_PrepareTransmit(void)
 {
 	BK4819_ExitBypass();
@@ -1276,31 +1354,6 @@ void BK4819_PlayDTMF(char Code)
 	}
 }
 
-void BK4819_PlayDTMFString(const char *pString, bool bDelayFirst, uint16_t FirstCodePersistTime, uint16_t HashCodePersistTime, uint16_t CodePersistTime, uint16_t CodeInternalTime)
-{
-	unsigned int i;
-
-	if (pString == NULL)
-		return;
-
-	for (i = 0; pString[i]; i++)
-	{
-		uint16_t Delay;
-		BK4819_PlayDTMF(pString[i]);
-		BK4819_ExitTxMute();
-		if (bDelayFirst && i == 0)
-			Delay = FirstCodePersistTime;
-		else
-		if (pString[i] == '*' || pString[i] == '#')
-			Delay = HashCodePersistTime;
-		else
-			Delay = CodePersistTime;
-		SYSTEM_DelayMs(Delay);
-		BK4819_EnterTxMute();
-		SYSTEM_DelayMs(CodeInternalTime);
-	}
-}
-
 void BK4819_TransmitTone(bool bLocalLoopback, uint32_t Frequency)
 {
 	BK4819_EnterTxMute();
@@ -1486,6 +1539,17 @@ bool BK4819_GetFrequencyScanResult(uint32_t *pFrequency)
 	return Finished;
 }
 
+bool BK4819_GetCTCSSScanResult(uint16_t *pCtcssFreq)
+{
+	const uint16_t Low = BK4819_ReadRegister(BK4819_REG_68);
+
+	if ((Low & 0x8000) != 0)
+		return false;
+
+	*pCtcssFreq = ((Low & 0x1FFF) * 4843) / 10000;
+	return true;
+}
+
 BK4819_CssScanResult_t BK4819_GetCxCSSScanResult(uint32_t *pCdcssFreq, uint16_t *pCtcssFreq)
 {
 	uint16_t Low;
@@ -1498,13 +1562,8 @@ BK4819_CssScanResult_t BK4819_GetCxCSSScanResult(uint32_t *pCdcssFreq, uint16_t
 		return BK4819_CSS_RESULT_CDCSS;
 	}
 
-	Low = BK4819_ReadRegister(BK4819_REG_68);
-
-	if ((Low & 0x8000) == 0)
-	{
-		*pCtcssFreq = ((Low & 0x1FFF) * 4843) / 10000;
+	if (BK4819_GetCTCSSScanResult(pCtcssFreq))
 		return BK4819_CSS_RESULT_CTCSS;
-	}
 
 	return BK4819_CSS_RESULT_NOT_FOUND;
 }
@@ -1623,6 +1682,56 @@ uint8_t BK4819_GetDTMF_5TONE_Code(void)
 	return (BK4819_ReadRegister(BK4819_REG_0B) >> 8) & 0x0F;
 }
 
+// latch every pending interrupt, with its DTMF code and FSK FIFO words read
+// straight away so they can't be overwritten or overrun before they're handled
+// the IRQ line isn't wired to the MCU, so while any source is enabled (always,
+// once RX is set up) REG_0C is still read on every 10ms tick like before
+bool BK4819_PollEvents(void)
+{
+	bool bLatched = false;
+
+	// only saves the read while every interrupt source is off
+	if (gBK4819_InterruptMask == 0)
+		return false;
+
+	while ((uint8_t)(gBK4819_EventHead - gBK4819_EventTail) < BK4819_EVENT_RING_SIZE) {
+		const uint16_t Reg0C = BK4819_ReadRegister(BK4819_REG_0C);
+		if ((Reg0C & 1u) == 0)
+			break;
+
+		BK4819_Event_t *pEvent = &gBK4819_Events[gBK4819_EventHead & (BK4819_EVENT_RING_SIZE - 1)];
+
+		BK4819_WriteRegister(BK4819_REG_02, 0);
+		pEvent->Status = BK4819_ReadRegister(BK4819_REG_02);
+		pEvent->Reg0C  = Reg0C;
+
+		if (pEvent->Status & BK4819_REG_02_MASK_DTMF_5TONE_FOUND)
+			pEvent->Dtmf = BK4819_GetDTMF_5TONE_Code();
+
+		if (pEvent->Status & BK4819_REG_02_MASK_FSK_FIFO_ALMOST_FULL)
+			for (unsigned int i = 0; i < ARRAY_SIZE(pEvent->Fifo); i++)
+				pEvent->Fifo[i] = BK4819_ReadRegister(BK4819_REG_5F);
+
+		// publish only once the entry is complete
+		gBK4819_EventHead++;
+		bLatched = true;
+	}
+
+	return bLatched;
+}
+
+bool BK4819_GetEvent(BK4819_Event_t *pEvent)
+{
+	const uint8_t Tail = gBK4819_EventTail;
+
+	if (Tail == gBK4819_EventHead)
+		return false;
+
+	*pEvent = gBK4819_Events[Tail & (BK4819_EVENT_RING_SIZE - 1)];
+	gBK4819_EventTail = Tail + 1;
+	return true;
+}
+
 uint8_t BK4819_GetCDCSSCodeType(void)
 {
 	return (BK4819_ReadRegister(BK4819_REG_0C) >> 14) & 3u;
@@ -1686,44 +1795,8 @@ void BK4819_PrepareFSKReceive(void)
 	BK4819_WriteRegister(BK4819_REG_59, 0x3068);
 }
 
-static void BK4819_PlayRogerNormal(void)
-{
-	#if 0
-		const uint32_t tone1_Hz = 500;
-		const uint32_t tone2_Hz = 700;
-	#else
-		// motorola type
-		const uint32_t tone1_Hz = 1540;
-		const uint32_t tone2_Hz = 1310;
-	#endif
-
-
-	BK4819_EnterTxMute();
-	BK4819_SetAF(BK4819_AF_MUTE);
-
-	BK4819_WriteRegister(BK4819_REG_70, BK4819_REG_70_ENABLE_TONE1 | (66u << BK4819_REG_70_SHIFT_TONE1_TUNING_GAIN));
-
-	BK4819_EnableTXLink();
-	SYSTEM_DelayMs(50);
-
-	BK4819_WriteRegister(BK4819_REG_71, scale_freq(tone1_Hz));
-
-	BK4819_ExitTxMute();
-	SYSTEM_DelayMs(80);
-	BK4819_EnterTxMute();
-
-	BK4819_WriteRegister(BK4819_REG_71, scale_freq(tone2_Hz));
-
-	BK4819_ExitTxMute();
-	SYSTEM_DelayMs(80);
-	BK4819_EnterTxMute();
-
-	BK4819_WriteRegister(BK4819_REG_70, 0x0000);
-	BK4819_WriteRegister(BK4819_REG_30, 0xC1FE);   // 1 1 0000 0 1 1111 1 1 1 0
-}
-
-
-void BK4819_PlayRogerMDC(void)
+// the roger is timed by the caller: load, 20ms, send, 180ms, stop
+void BK4819_LoadRogerMDC(void)
 {
 	struct reg_value {
 		BK4819_REGISTER_t reg;
@@ -1758,28 +1831,22 @@ void BK4819_PlayRogerMDC(void)
 		BK4819_WriteRegister(BK4819_REG_5F, FSK_RogerTable[i]);
 	}
 
-	SYSTEM_DelayMs(20);
+}
 
+void BK4819_SendRogerMDC(void)
+{
 	// 4 sync bytes, 6 byte preamble, Enable FSK TX
 	BK4819_WriteRegister(BK4819_REG_59, 0x0868);
+}
 
-	SYSTEM_DelayMs(180);
-
+void BK4819_StopRogerMDC(void)
+{
 	// Stop FSK TX, reset Tone-2, disable FSK
 	BK4819_WriteRegister(BK4819_REG_59, 0x0068);
 	BK4819_WriteRegister(BK4819_REG_70, 0x0000);
 	BK4819_WriteRegister(BK4819_REG_58, 0x0000);
 }
 
-void BK4819_PlayRoger(void)
-{
-	if (gEeprom.ROGER == ROGER_MODE_ROGER) {
-		BK4819_PlayRogerNormal();
-	} else if (gEeprom.ROGER == ROGER_MODE_MDC) {
-		BK4819_PlayRogerMDC();
-	}
-}
-
 void BK4819_Enable_AfDac_DiscMode_TxDsp(void)
 {
 	BK4819_WriteRegister(BK4819_REG_30, 0x0000);
@@ -62,6 +62,26 @@ enum BK4819_CssScanResult_t
 
 typedef enum BK4819_CssScanResult_t BK4819_CssScanResult_t;
 
+// one REG_02 interrupt status, latched together with the registers that
+// only stay valid until the next event
+typedef struct {
+	uint16_t Status;     // REG_02
+	uint16_t Reg0C;      // CDCSS code type, CTC shift
+	uint16_t Fifo[4];    // REG_5F words when FSK_FIFO_ALMOST_FULL is set
+	uint8_t  Dtmf;       // REG_0B code when DTMF_5TONE_FOUND is set
+} BK4819_Event_t;
+
+// the registers key up writes that only depend on the channel, worked out
+// ahead so the TX path is a burst of writes
+typedef struct {
+	uint32_t Frequency;
+	uint16_t Reg43;      // filter bandwidth
+	uint16_t Reg36;      // PA bias and gain
+	uint16_t Reg51;      // CxCSS mode, 0 = off
+	uint16_t Reg07;      // CxCSS frequency
+	uint16_t Reg08[2];   // CDCSS code word, low then high 12 bits
+} BK4819_TxImage_t;
+
 // radio is asleep, not listening
 extern bool gRxIdleMode;
 
@@ -105,7 +125,9 @@ void     BK4819_DisableVox(void);
 void     BK4819_DisableDTMF(void);
 void     BK4819_EnableDTMF(void);
 void     BK4819_PlayTone(uint16_t Frequency, bool bTuningGainSwitch);
-void     BK4819_PlaySingleTone(const unsigned int tone_Hz, const unsigned int delay, const unsigned int level, const bool play_speaker);
+void     BK4819_StartTone1(const unsigned int level, const bool play_speaker);
+void     BK4819_SetToneFrequency(const uint16_t tone_Hz);
+void     BK4819_StopTone1(void);
 void     BK4819_EnterTxMute(void);
 void     BK4819_ExitTxMute(void);
 void     BK4819_Sleep(void);
@@ -116,6 +138,10 @@ void     BK4819_TurnsOffTones_TurnsOnRX(void);
 void     BK4819_ResetFSK(void);
 void     BK4819_Idle(void);
 void     BK4819_ExitBypass(void);
+void     BK4819_BuildTxImage(BK4819_TxImage_t *pImage, const uint32_t Frequency, const BK4819_FilterBandwidth_t Bandwidth, const bool weak_no_different, const uint8_t bias);
+void     BK4819_SetTxImageCTCSS(BK4819_TxImage_t *pImage, uint32_t FreqControlWord);
+void     BK4819_SetTxImageCDCSS(BK4819_TxImage_t *pImage, uint32_t CodeWord);
+void     BK4819_WriteTxImage(const BK4819_TxImage_t *pImage);
 void     BK4819_PrepareTransmit(void);
 void     BK4819_TxOn_Beep(void);
 void     BK4819_ExitSubAu(void);
@@ -127,7 +153,6 @@ void     BK4819_ExitDTMF_TX(bool bKeep);
 void     BK4819_EnableTXLink(void);
 
 void     BK4819_PlayDTMF(char Code);
-void     BK4819_PlayDTMFString(const char *pString, bool bDelayFirst, uint16_t FirstCodePersistTime, uint16_t HashCodePersistTime, uint16_t CodePersistTime, uint16_t CodeInternalTime);
 
 void     BK4819_TransmitTone(bool bLocalLoopback, uint32_t Frequency);
 
@@ -144,6 +169,7 @@ uint16_t BK4819_GetVoiceAmplitudeOut(void);
 uint8_t  BK4819_GetAfTxRx(void);
 
 bool     BK4819_GetFrequencyScanResult(uint32_t *pFrequency);
+bool     BK4819_GetCTCSSScanResult(uint16_t *pCtcssFreq);
 BK4819_CssScanResult_t BK4819_GetCxCSSScanResult(uint32_t *pCdcssFreq, uint16_t *pCtcssFreq);
 void     BK4819_DisableFrequencyScan(void);
 void     BK4819_EnableFrequencyScan(void);
@@ -155,6 +181,9 @@ void     BK4819_StopScan(void);
 
 uint8_t  BK4819_GetDTMF_5TONE_Code(void);
 
+bool     BK4819_PollEvents(void);
+bool     BK4819_GetEvent(BK4819_Event_t *pEvent);
+
 uint8_t  BK4819_GetCDCSSCodeType(void);
 uint8_t  BK4819_GetCTCShift(void);
 uint8_t  BK4819_GetCTCType(void);
@@ -162,7 +191,9 @@ uint8_t  BK4819_GetCTCType(void);
 void     BK4819_SendFSKData(uint16_t *pData);
 void     BK4819_PrepareFSKReceive(void);
 
-void     BK4819_PlayRoger(void);
+void     BK4819_LoadRogerMDC(void);
+void     BK4819_SendRogerMDC(void);
+void     BK4819_StopRogerMDC(void);
 
 void     BK4819_Enable_AfDac_DiscMode_TxDsp(void);
 
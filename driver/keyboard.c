@@ -27,6 +27,13 @@ KEY_Code_t gKeyReading1     = KEY_INVALID;
 uint16_t   gDebounceCounter = 0;
 bool       gWasFKeyPressed  = false;
 
+// a press, a release and a few repeats fit before APP_Update gets to them
+#define KEYBOARD_EVENT_QUEUE_SIZE 8
+
+static KEYBOARD_Event_t gKeyEvents[KEYBOARD_EVENT_QUEUE_SIZE];
+static uint8_t          gKeyEventsHead;   // next to pop
+static uint8_t          gKeyEventsCount;
+
 static const struct {
 
 	// Using a 16 bit pre-calculated shift and invert is cheaper
@@ -92,6 +99,17 @@ static const struct {
 	}
 };
 
+static void ReleaseRows(void)
+{
+	// Create I2C stop condition since we might have toggled I2C pins
+	// This leaves GPIOA_PIN_KEYBOARD_4 and GPIOA_PIN_KEYBOARD_5 high
+	I2C_Stop();
+
+	// Reset VOICE pins
+	GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_KEYBOARD_6);
+	GPIO_SetBit(  &GPIOA->DATA, GPIOA_PIN_KEYBOARD_7);
+}
+
 KEY_Code_t KEYBOARD_Poll(void)
 {
 	KEY_Code_t Key = KEY_INVALID;
@@ -141,13 +159,51 @@ KEY_Code_t KEYBOARD_Poll(void)
 			break;
 	}
 
-	// Create I2C stop condition since we might have toggled I2C pins
-	// This leaves GPIOA_PIN_KEYBOARD_4 and GPIOA_PIN_KEYBOARD_5 high
-	I2C_Stop();
-
-	// Reset VOICE pins
-	GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_KEYBOARD_6);
-	GPIO_SetBit(  &GPIOA->DATA, GPIOA_PIN_KEYBOARD_7);
+	ReleaseRows();
 
 	return Key;
 }
+
+// all rows pulled low at once, any pressed key (the side keys need no row)
+// then pulls its column low, so one read tells if the matrix needs a scan
+bool KEYBOARD_IsAnyKeyPressed(void)
+{
+	const uint16_t columns =
+		1u << GPIOA_PIN_KEYBOARD_0 |
+		1u << GPIOA_PIN_KEYBOARD_1 |
+		1u << GPIOA_PIN_KEYBOARD_2 |
+		1u << GPIOA_PIN_KEYBOARD_3;
+
+	GPIOA->DATA &= ~(1u << GPIOA_PIN_KEYBOARD_4 |
+					 1u << GPIOA_PIN_KEYBOARD_5 |
+					 1u << GPIOA_PIN_KEYBOARD_6 |
+					 1u << GPIOA_PIN_KEYBOARD_7);
+
+	SYSTICK_DelayUs(1);
+	const uint16_t reg = GPIOA->DATA;
+
+	ReleaseRows();
+
+	return (reg & columns) != columns;
+}
+
+bool KEYBOARD_PushEvent(const KEYBOARD_Event_t *pEvent)
+{
+	if (gKeyEventsCount >= KEYBOARD_EVENT_QUEUE_SIZE)
+		return false;
+
+	gKeyEvents[(gKeyEventsHead + gKeyEventsCount) % KEYBOARD_EVENT_QUEUE_SIZE] = *pEvent;
+	gKeyEventsCount++;
+	return true;
+}
+
+bool KEYBOARD_PopEvent(KEYBOARD_Event_t *pEvent)
+{
+	if (gKeyEventsCount == 0)
+		return false;
+
+	*pEvent = gKeyEvents[gKeyEventsHead];
+	gKeyEventsHead = (gKeyEventsHead + 1) % KEYBOARD_EVENT_QUEUE_SIZE;
+	gKeyEventsCount--;
+	return true;
+}
@@ -45,12 +45,25 @@ enum KEY_Code_e {
 };
 typedef enum KEY_Code_e KEY_Code_t;
 
+// a debounced key event, queued by the 10ms scan and handled from APP_Update
+typedef struct {
+	KEY_Code_t Key;
+	bool       bKeyPressed;
+	bool       bKeyHeld;
+#ifdef ENABLE_PROFILING
+	uint32_t   Edge_us;      // when the first undebounced edge was seen
+#endif
+} KEYBOARD_Event_t;
+
 extern KEY_Code_t gKeyReading0;
 extern KEY_Code_t gKeyReading1;
 extern uint16_t   gDebounceCounter;
 extern bool       gWasFKeyPressed;
 
 KEY_Code_t KEYBOARD_Poll(void);
+bool       KEYBOARD_IsAnyKeyPressed(void);
+bool       KEYBOARD_PushEvent(const KEYBOARD_Event_t *pEvent);
+bool       KEYBOARD_PopEvent(KEYBOARD_Event_t *pEvent);
 
 #endif
 
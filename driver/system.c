@@ -16,8 +16,19 @@
 
 #include "../bsp/dp32g030/pmu.h"
 #include "../bsp/dp32g030/syscon.h"
+#include "adc.h"
+#include "backlight.h"
+#ifdef ENABLE_OVERLAY
+	#include "flash.h"
+	#include "../sram-overlay.h"
+#endif
 #include "system.h"
 #include "systick.h"
+#ifdef ENABLE_UART
+	#include "uart.h"
+#endif
+
+static SYSTEM_Clock_t gClock = SYSTEM_CLOCK_48MHZ;
 
 void SYSTEM_DelayMs(uint32_t Delay)
 {
@@ -35,3 +46,55 @@ void SYSTEM_ConfigureClocks(void)
 	// Disable division clock gate
 	SYSCON_DIV_CLK_GATE = (SYSCON_DIV_CLK_GATE & ~SYSCON_DIV_CLK_GATE_DIV_CLK_GATE_MASK) | SYSCON_DIV_CLK_GATE_DIV_CLK_GATE_BITS_DISABLE;
 }
+
+// the divided clocks run from DIV_CLK, full speed stays on RCHF as configured at boot
+// call right after a systick, the tick in progress restarts at the new rate
+void SYSTEM_SetClock(SYSTEM_Clock_t Clock)
+{
+	if (Clock == gClock)
+		return;
+
+#ifdef ENABLE_OVERLAY
+	// the flash needs its second wait state before the core speeds up
+	if (Clock < gClock) {
+		overlay_FLASH_MainClock       = 48000000 >> Clock;
+		overlay_FLASH_ClockMultiplier = 48 >> Clock;
+		FLASH_Init(FLASH_READ_MODE_2_CYCLE);
+	}
+#endif
+
+#ifdef ENABLE_UART
+	UART_WaitTxIdle();
+#endif
+
+	// only the SYS and DIV fields change, the SARADC sample clock and PLL
+	// fields read back shifted, ADC_GetClockConfig puts them where writes expect them
+	const uint32_t Sel = ADC_GetClockConfig() & ~(SYSCON_CLK_SEL_SYS_MASK | SYSCON_CLK_SEL_DIV_MASK);
+
+	if (Clock == SYSTEM_CLOCK_48MHZ)
+		SYSCON_CLK_SEL = Sel | SYSCON_CLK_SEL_SYS_BITS_RCHF | SYSCON_CLK_SEL_DIV_BITS_2;
+	else
+		SYSCON_CLK_SEL = Sel | SYSCON_CLK_SEL_SYS_BITS_DIV_CLK | ((Clock << SYSCON_CLK_SEL_DIV_SHIFT) & SYSCON_CLK_SEL_DIV_MASK);
+
+#ifdef ENABLE_OVERLAY
+	// and a single one is enough once it has slowed down
+	if (Clock > gClock) {
+		overlay_FLASH_MainClock       = 48000000 >> Clock;
+		overlay_FLASH_ClockMultiplier = 48 >> Clock;
+		FLASH_Init(FLASH_READ_MODE_1_CYCLE);
+	}
+#endif
+
+	gClock = Clock;
+
+	SYSTICK_SetTickMultiplier(48 >> Clock);
+#ifdef ENABLE_UART
+	UART_SetClockShift(Clock);
+#endif
+	BACKLIGHT_SetClockShift(Clock);
+}
+
+SYSTEM_Clock_t SYSTEM_GetClock(void)
+{
+	return gClock;
+}
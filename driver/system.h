@@ -19,8 +19,17 @@
 
 #include <stdint.h>
 
+// the value is the power of two the 48MHz RCHF is divided by
+typedef enum {
+	SYSTEM_CLOCK_48MHZ = 0,
+	SYSTEM_CLOCK_24MHZ,
+	SYSTEM_CLOCK_12MHZ,
+} SYSTEM_Clock_t;
+
 void SYSTEM_DelayMs(uint32_t Delay);
 void SYSTEM_ConfigureClocks(void);
+void SYSTEM_SetClock(SYSTEM_Clock_t Clock);
+SYSTEM_Clock_t SYSTEM_GetClock(void);
 
 #endif
 
@@ -20,11 +20,68 @@
 
 // 0x20000324
 static uint32_t gTickMultiplier;
+static volatile uint8_t gTickPeriod_10ms;      // period of the count in progress
+static volatile uint8_t gTickPeriodNext_10ms;  // in LOAD, used from the next reload
 
 void SYSTICK_Init(void)
 {
 	SysTick_Config(480000);
 	gTickMultiplier = 48;
+	gTickPeriod_10ms = 1;
+	gTickPeriodNext_10ms = 1;
+}
+
+// the systick interrupt accounts for every 10ms that passed, a longer period
+// only makes the timeslices coarser, max 34 (24 bit reload at 48MHz)
+// the count in progress is not disturbed, so the 10ms phase is kept
+void SYSTICK_SetPeriod_10ms(uint8_t Period)
+{
+	if (Period == 0 || Period == gTickPeriodNext_10ms)
+		return;
+
+	// a reload between the two would have the interrupt account the wrong period
+	__disable_irq();
+	SysTick->LOAD = (Period * gTickMultiplier * 10000) - 1;
+	gTickPeriodNext_10ms = Period;
+	__enable_irq();
+}
+
+// the core clock changed, the count in progress goes on at the new rate
+// VAL can only be cleared, so the rescaled remainder is loaded through LOAD
+// and the full period goes back into LOAD once the counter has taken it
+void SYSTICK_SetTickMultiplier(uint32_t Multiplier)
+{
+	__disable_irq();
+
+	uint32_t remaining = SysTick->VAL * Multiplier / gTickMultiplier;
+	if (remaining < 100)
+		remaining = 100;   // long enough to see the reload below
+
+	gTickMultiplier = Multiplier;
+	SysTick->LOAD   = remaining - 1;
+	SysTick->VAL    = 0;   // reloads from LOAD on the next clock
+	while (SysTick->VAL == 0) {}
+	SysTick->LOAD   = (gTickPeriodNext_10ms * Multiplier * 10000) - 1;
+
+	__enable_irq();
+}
+
+uint8_t SYSTICK_GetPeriod_10ms(void)
+{
+	return gTickPeriod_10ms;
+}
+
+// called from the systick interrupt, returns the number of 10ms that just elapsed
+uint8_t SYSTICK_GetElapsed_10ms(void)
+{
+	const uint8_t elapsed = gTickPeriod_10ms;
+	gTickPeriod_10ms = gTickPeriodNext_10ms;
+	return elapsed;
+}
+
+uint32_t SYSTICK_GetTickMultiplier(void)
+{
+	return gTickMultiplier;
 }
 
 void SYSTICK_DelayUs(uint32_t Delay)
@@ -21,6 +21,11 @@
 
 void SYSTICK_Init(void);
 void SYSTICK_DelayUs(uint32_t Delay);
+uint32_t SYSTICK_GetTickMultiplier(void);
+void SYSTICK_SetTickMultiplier(uint32_t Multiplier);
+void SYSTICK_SetPeriod_10ms(uint8_t Period);
+uint8_t SYSTICK_GetPeriod_10ms(void);
+uint8_t SYSTICK_GetElapsed_10ms(void);
 
 #endif
 
@@ -21,6 +21,7 @@
 #include "driver/uart.h"
 
 static bool UART_IsLogEnabled;
+static uint32_t UART_BaudDivider;   // at the full 48MHz core clock
 uint8_t UART_DMA_Buffer[256];
 
 void UART_Init(void)
@@ -39,7 +40,8 @@ void UART_Init(void)
 		Frequency = 48000000U - Frequency;
 	}
 
-	UART1->BAUD = Frequency / 39053U;
+	UART_BaudDivider = Frequency / 39053U;
+	UART1->BAUD = UART_BaudDivider;
 	UART1->CTRL = UART_CTRL_RXEN_BITS_ENABLE | UART_CTRL_TXEN_BITS_ENABLE | UART_CTRL_RXDMAEN_BITS_ENABLE;
 	UART1->RXTO = 4;
 	UART1->FC = 0;
@@ -96,6 +98,20 @@ void UART_Send(const void *pBuffer, uint32_t Size)
 	}
 }
 
+// the UART counts core clocks, keep 38400 baud when the core clock is divided
+void UART_SetClockShift(uint8_t Shift)
+{
+	UART1->BAUD = UART_BaudDivider >> Shift;
+}
+
+// a byte still shifting out would be garbled by a clock change
+void UART_WaitTxIdle(void)
+{
+	while ((UART1->IF & UART_IF_TXFIFO_EMPTY_MASK) == UART_IF_TXFIFO_EMPTY_BITS_NOT_SET ||
+	       (UART1->IF & UART_IF_TXBUSY_MASK) != UART_IF_TXBUSY_BITS_NOT_SET) {
+	}
+}
+
 void UART_LogSend(const void *pBuffer, uint32_t Size)
 {
 	if (UART_IsLogEnabled) {
@@ -25,6 +25,8 @@ extern uint8_t UART_DMA_Buffer[256];
 void UART_Init(void);
 void UART_Send(const void *pBuffer, uint32_t Size);
 void UART_LogSend(const void *pBuffer, uint32_t Size);
+void UART_SetClockShift(uint8_t Shift);
+void UART_WaitTxIdle(void);
 
 #endif
 
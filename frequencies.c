@@ -15,9 +15,11 @@
  */
 
 #include "frequencies.h"
+#include "helper/fixed.h"
 #include "misc.h"
 #include "settings.h"
 #include <assert.h>
+#include <string.h>
 
 // the BK4819 has 2 bands it covers, 18MHz ~ 630MHz and 760MHz ~ 1300MHz
 
@@ -115,7 +117,7 @@ uint32_t FREQUENCY_GetSortedIdxFromStepIdx(uint8_t stepIdx)
 static_assert(ARRAY_SIZE(gStepFrequencyTable) == STEP_N_ELEM);
 
 
-FREQUENCY_Band_t FREQUENCY_GetBand(uint32_t Frequency)
+static FREQUENCY_Band_t GetBand(uint32_t Frequency)
 {
 	for (int32_t band = BAND_N_ELEM - 1; band >= 0; band--)
 		if (Frequency >= frequencyBandTable[band].lower)
@@ -146,20 +148,26 @@ uint8_t FREQUENCY_CalculateOutputPower(uint8_t TxpLow, uint8_t TxpMid, uint8_t T
 
 uint32_t FREQUENCY_RoundToStep(uint32_t freq, uint16_t step)
 {
+	// called for every frequency entered, scanned or stepped, the step rarely changes
+	static FIXED_Divider_t stepDiv, div2500, div700;
+
 	if(step == 833) {
-        uint32_t base = freq/2500*2500;
-        int chno = (freq - base) / 700;    // convert entered aviation 8.33Khz channel number scheme to actual frequency. 
+		FIXED_SetDivisor(&div2500, 2500);
+		FIXED_SetDivisor(&div700, 700);
+        uint32_t base = FIXED_Divide(freq, &div2500)*2500;
+        int chno = FIXED_Divide(freq - base, &div700);    // convert entered aviation 8.33Khz channel number scheme to actual frequency. 
         return base + (chno * 833) + (chno == 3);
 	}
 
-	if(step == 1)
+	if(step <= 1)
 		return freq;
 	if(step >= 1000) 
 		step = step/2;
-	return (freq + (step + 1) / 2) / step * step;
+	FIXED_SetDivisor(&stepDiv, step);
+	return FIXED_Divide(freq + (step + 1) / 2, &stepDiv) * step;
 }
 
-int32_t TX_freq_check(const uint32_t Frequency)
+static int32_t TxCheck(const uint32_t Frequency)
 {	// return '0' if TX frequency is allowed
 	// otherwise return '-1'
 
@@ -236,7 +244,7 @@ int32_t TX_freq_check(const uint32_t Frequency)
 	return -1;
 }
 
-int32_t RX_freq_check(const uint32_t Frequency)
+static int32_t RxCheck(const uint32_t Frequency)
 {	// return '0' if RX frequency is allowed
 	// otherwise return '-1'
 
@@ -248,3 +256,117 @@ int32_t RX_freq_check(const uint32_t Frequency)
 
 	return 0;   // OK frequency
 }
+
+// *************************************************************************
+// compiled band plan
+
+// every frequency the checks above compare against, TxCheck() included,
+// keep in sync when adding a rule there
+static const uint32_t BandPlanEdges[] = {
+	BX4819_band1_lower, 5000000, 7600000, 10800000, 13700000, 17400000, 35000000,
+	40000000, 47000000, 60000000, 63000000, 84000000, BX4819_band2_upper,
+	14400000, 14600000, 14800000, 42000000, 43000000, 43800000, 44000000, 45000000
+};
+
+#define BAND_PLAN_SIZE 32
+
+// the checks only compare with '<', '<=', '>=' or '>', so their results can
+// only change at an edge or one above it, in between they're constant
+static struct {
+	uint8_t  lock[5];     // the settings the plan was compiled for
+	uint8_t  count;       // 0 = not compiled or didn't fit, use the checks
+	uint32_t start[BAND_PLAN_SIZE];
+	FREQUENCY_Plan_t info[BAND_PLAN_SIZE];
+} gBandPlan;
+
+static FREQUENCY_Plan_t Evaluate(uint32_t Frequency)
+{
+	const int32_t          tx   = TxCheck(Frequency);
+	const FREQUENCY_Plan_t info = {
+		.band       = GetBand(Frequency),
+		.rxAllowed  = RxCheck(Frequency) == 0,
+		.txAllowed  = tx == 0,
+		.txOutside  = tx > 0,
+	};
+	return info;
+}
+
+static bool SamePlan(FREQUENCY_Plan_t a, FREQUENCY_Plan_t b)
+{
+	return a.band == b.band && a.rxAllowed == b.rxAllowed && a.txAllowed == b.txAllowed && a.txOutside == b.txOutside;
+}
+
+static void CompileBandPlan(const uint8_t lock[5])
+{
+	memcpy(gBandPlan.lock, lock, sizeof(gBandPlan.lock));
+	gBandPlan.count = 0;
+
+	uint32_t edge = 0;
+	while (true) {
+		const FREQUENCY_Plan_t info = Evaluate(edge);
+
+		if (gBandPlan.count == 0 || !SamePlan(info, gBandPlan.info[gBandPlan.count - 1])) {
+			if (gBandPlan.count >= BAND_PLAN_SIZE) {
+				gBandPlan.count = 0;
+				return;
+			}
+			gBandPlan.start[gBandPlan.count] = edge;
+			gBandPlan.info[gBandPlan.count]  = info;
+			gBandPlan.count++;
+		}
+
+		// next edge up, each edge counts twice: itself and one above it
+		uint32_t next = UINT32_MAX;
+		for (unsigned int i = 0; i < ARRAY_SIZE(BandPlanEdges); i++) {
+			const uint32_t e = BandPlanEdges[i];
+			if (e > edge && e < next)
+				next = e;
+			else if (e + 1 > edge && e + 1 < next)
+				next = e + 1;
+		}
+
+		if (next == UINT32_MAX)
+			return;
+		edge = next;
+	}
+}
+
+FREQUENCY_Plan_t FREQUENCY_Lookup(uint32_t Frequency)
+{
+	const uint8_t lock[5] = {gSetting_F_LOCK, gSetting_200TX, gSetting_350TX, gSetting_350EN, gSetting_500TX};
+
+	if (memcmp(lock, gBandPlan.lock, sizeof(lock)) != 0 || gBandPlan.count == 0) {
+		CompileBandPlan(lock);
+		if (gBandPlan.count == 0)
+			return Evaluate(Frequency);
+	}
+
+	// last segment starting at or below the frequency
+	unsigned int lo = 0;
+	unsigned int hi = gBandPlan.count - 1;
+	while (lo < hi) {
+		const unsigned int mid = (lo + hi + 1) / 2;
+		if (gBandPlan.start[mid] <= Frequency)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	return gBandPlan.info[lo];
+}
+
+FREQUENCY_Band_t FREQUENCY_GetBand(uint32_t Frequency)
+{
+	return FREQUENCY_Lookup(Frequency).band;
+}
+
+int32_t TX_freq_check(const uint32_t Frequency)
+{
+	const FREQUENCY_Plan_t info = FREQUENCY_Lookup(Frequency);
+	return info.txAllowed ? 0 : (info.txOutside ? 1 : -1);
+}
+
+int32_t RX_freq_check(const uint32_t Frequency)
+{
+	return FREQUENCY_Lookup(Frequency).rxAllowed ? 0 : -1;
+}
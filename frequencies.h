@@ -17,6 +17,7 @@
 #ifndef FREQUENCIES_H
 #define FREQUENCIES_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #define _1GHz_in_KHz 100000000
@@ -43,6 +44,14 @@ typedef enum  {
 
 extern const freq_band_table_t frequencyBandTable[];
 
+// everything the band plan says about a frequency, from one lookup
+typedef struct {
+	FREQUENCY_Band_t band      : 4;
+	bool             rxAllowed : 1;
+	bool             txAllowed : 1;
+	bool             txOutside : 1;   // below or above all bands
+} FREQUENCY_Plan_t;
+
 typedef enum {
 // standard steps
 	STEP_2_5kHz,
@@ -80,6 +89,7 @@ extern const uint16_t gStepFrequencyTable[];
 	extern const uint32_t NoaaFrequencyTable[10];
 #endif
 
+FREQUENCY_Plan_t FREQUENCY_Lookup(uint32_t Frequency);
 FREQUENCY_Band_t FREQUENCY_GetBand(uint32_t Frequency);
 uint8_t          FREQUENCY_CalculateOutputPower(uint8_t TxpLow, uint8_t TxpMid, uint8_t TxpHigh, int32_t LowerLimit, int32_t Middle, int32_t UpperLimit, int32_t Frequency);
 uint32_t 		 FREQUENCY_RoundToStep(uint32_t freq, uint16_t step);
@@ -16,6 +16,9 @@
 
 #include <string.h>
 
+#ifdef ENABLE_CHANNEL_STATS
+	#include "app/chstats.h"
+#endif
 #include "app/dtmf.h"
 #if defined(ENABLE_FMRADIO)
 	#include "app/fm.h"
@@ -34,6 +37,7 @@
 #include "frequencies.h"
 #include "functions.h"
 #include "helper/battery.h"
+#include "helper/task.h"
 #include "misc.h"
 #include "radio.h"
 #include "settings.h"
@@ -67,6 +71,10 @@ void FUNCTION_Init(void)
 
 	gCurrentCodeType = (gRxVfo->Modulation != MODULATION_FM) ? CODE_TYPE_OFF : gRxVfo->pRX->CodeType;
 
+#ifdef ENABLE_CSS_DECODE
+	gRxCssDecodeType = CODE_TYPE_OFF;
+#endif
+
 #ifdef ENABLE_VOX
 	g_VOX_Lost     = false;
 #endif
@@ -118,7 +126,7 @@ void FUNCTION_Foreground(const FUNCTION_Type_t PreviousFunction)
 }
 
 void FUNCTION_PowerSave() {
-	gPowerSave_10ms = gEeprom.BATTERY_SAVE * 10;
+	gPowerSave_10ms = power_save_sleep_10ms[gEeprom.BATTERY_SAVE];
 	gPowerSaveCountdownExpired = false;
 
 	gRxIdleMode = true;
@@ -136,6 +144,49 @@ void FUNCTION_PowerSave() {
 		GUI_SelectNextDisplay(DISPLAY_MAIN);
 }
 
+#ifdef ENABLE_ALARM
+// stopped by FUNCTION_Select, whatever turns the alarm off goes through it
+static bool FUNCTION_SiteAlarmTask(TASK_Context_t *pTask)
+{
+	TASK_BEGIN(pTask);
+
+	AUDIO_AudioPathOff();
+
+	TASK_YIELD_FOR(pTask, 20);
+
+	BK4819_PlayTone(500, 0);
+	SYSTEM_DelayMs(2);
+
+	AUDIO_AudioPathOn();
+
+	gEnableSpeaker = true;
+
+	TASK_YIELD_FOR(pTask, 60);
+
+	BK4819_ExitTxMute();
+
+	gAlarmToneCounter = 0;
+
+	TASK_END(pTask);
+}
+#endif
+
+static void FUNCTION_TransmitScramble(void)
+{
+	if (gCurrentFunction != FUNCTION_TRANSMIT)
+		return;
+
+#if defined(ENABLE_ALARM) || defined(ENABLE_TX1750)
+	if (gAlarmState != ALARM_STATE_OFF)
+		return;
+#endif
+
+	if (gCurrentVfo->SCRAMBLING_TYPE > 0 && gSetting_ScrambleEnable)
+		BK4819_EnableScramble(gCurrentVfo->SCRAMBLING_TYPE - 1);
+	else
+		BK4819_DisableScramble();
+}
+
 void FUNCTION_Transmit()
 {
 	// if DTMF is enabled when TX'ing, it changes the TX audio filtering !! .. 1of11
@@ -147,8 +198,7 @@ void FUNCTION_Transmit()
 #endif
 
 	// clear the DTMF RX live decoder buffer
-	gDTMF_RX_live_timeout = 0;
-	memset(gDTMF_RX_live, 0, sizeof(gDTMF_RX_live));
+	DTMF_clear_RX_live();
 
 #if defined(ENABLE_FMRADIO)
 	if (gFmRadioMode)
@@ -160,40 +210,29 @@ void FUNCTION_Transmit()
 	{
 		GUI_DisplayScreen();
 
-		AUDIO_AudioPathOff();
-
-		SYSTEM_DelayMs(20);
-		BK4819_PlayTone(500, 0);
-		SYSTEM_DelayMs(2);
-
-		AUDIO_AudioPathOn();
-
-		gEnableSpeaker = true;
-
-		SYSTEM_DelayMs(60);
-		BK4819_ExitTxMute();
-
 		gAlarmToneCounter = 0;
+		TASK_Start(FUNCTION_SiteAlarmTask);
 		return;
 	}
 #endif
 
-	gUpdateStatus = true;
-
-	GUI_DisplayScreen();
-
 	RADIO_SetTxParameters();
 
 	// turn the RED LED on
 	BK4819_ToggleGpioOut(BK4819_GPIO5_PIN1_RED, true);
 
-	DTMF_Reply();
+	// the carrier is up, the screen can catch up
+	gUpdateStatus = true;
+
+	GUI_DisplayScreen();
 
-	if (gCurrentVfo->DTMF_PTT_ID_TX_MODE == PTT_ID_APOLLO)
-		BK4819_PlaySingleTone(2525, 250, 0, gEeprom.DTMF_SIDE_TONE);
+	// the PTT ID goes out from the timeslice, scrambling starts after it
+	DTMF_Reply(FUNCTION_TransmitScramble);
 
 #if defined(ENABLE_ALARM) || defined(ENABLE_TX1750)
 	if (gAlarmState != ALARM_STATE_OFF) {
+		AUDIO_WaitTone();
+
 		#ifdef ENABLE_TX1750
 		if (gAlarmState == ALARM_STATE_TX1750)
 			BK4819_TransmitTone(true, 1750);
@@ -214,11 +253,6 @@ void FUNCTION_Transmit()
 	}
 #endif
 
-	if (gCurrentVfo->SCRAMBLING_TYPE > 0 && gSetting_ScrambleEnable)
-		BK4819_EnableScramble(gCurrentVfo->SCRAMBLING_TYPE - 1);
-	else
-		BK4819_DisableScramble();
-
 	if (gSetting_backlight_on_tx_rx & BACKLIGHT_ON_TR_TX) {
 		BACKLIGHT_TurnOn();
 	}
@@ -231,8 +265,24 @@ void FUNCTION_Select(FUNCTION_Type_t Function)
 	const FUNCTION_Type_t PreviousFunction = gCurrentFunction;
 	const bool bWasPowerSave = PreviousFunction == FUNCTION_POWER_SAVE;
 
+	// finish whatever tone script owns the chip
+	const bool bReplyCut = AUDIO_StopTone();
+#ifdef ENABLE_ALARM
+	TASK_Stop(FUNCTION_SiteAlarmTask);
+#endif
+
 	gCurrentFunction = Function;
 
+	// a CSS reply cut short never gets to its hold and tail, back to RX here
+	if (bReplyCut && Function != FUNCTION_TRANSMIT)
+		RADIO_SetupRegisters(false);
+
+#ifdef ENABLE_CHANNEL_STATS
+	// however the reception ended, squelch, TX, scanner or power save
+	if (Function != FUNCTION_RECEIVE && Function != FUNCTION_INCOMING)
+		CHSTATS_Close();
+#endif
+
 	if (bWasPowerSave && Function != FUNCTION_POWER_SAVE) {
 		BK4819_Conditional_RX_TurnOn_and_GPIO6_Enable();
 		gRxIdleMode = false;
@@ -257,6 +307,12 @@ void FUNCTION_Select(FUNCTION_Type_t Function)
 			break;
 
 		case FUNCTION_INCOMING:
+#ifdef ENABLE_CSS_DECODE
+			// a squelch reopen doesn't always go through FUNCTION_Init
+			gRxCssDecodeType = CODE_TYPE_OFF;
+#endif
+			break;
+
 		case FUNCTION_RECEIVE:
 		case FUNCTION_BAND_SCOPE:
 		default:
@@ -16,11 +16,15 @@
 
 #include <assert.h>
 
+#include "ARMCM0.h"
 #include "battery.h"
+#include "board.h"
 #include "driver/backlight.h"
 #include "driver/st7565.h"
+#include "fixed.h"
 #include "functions.h"
 #include "misc.h"
+#include "radio.h"
 #include "settings.h"
 #include "ui/battery.h"
 #include "ui/menu.h"
@@ -29,7 +33,6 @@
 uint16_t          gBatteryCalibration[6];
 uint16_t          gBatteryCurrentVoltage;
 uint16_t          gBatteryCurrent;
-uint16_t          gBatteryVoltages[4];
 uint16_t          gBatteryVoltageAverage;
 uint8_t           gBatteryDisplayLevel;
 bool              gChargingWithTypeC;
@@ -50,6 +53,20 @@ const uint16_t 	  lowBatteryPeriod = 30;
 
 volatile uint16_t gPowerSave_10ms;
 
+// the ADC converts continuously, the latest result feeds a first order IIR
+// once per 10ms that passed since the last sample, time constant
+// ~ 2^BATTERY_FILTER_SHIFT * 10ms however stretched the tick is
+#define BATTERY_FILTER_SHIFT 5
+
+static uint32_t   gBatteryFiltered_q8;       // raw ADC << 8, TX sag added back
+static uint32_t   gBatteryTxFiltered_q8;     // raw ADC << 8 during the current TX
+static uint32_t   gBatteryRxReference_q8;    // filtered value when the TX started
+static uint32_t   gBatteryTxSag_q8[OUTPUT_POWER_HIGH + 1];
+static uint8_t    gBatteryTxSagLearned;      // bit per power level
+static uint8_t    gBatteryTxPower;
+static bool       gBatteryTransmitting;
+static volatile uint8_t gBatteryElapsed_10ms;
+
 
 const uint16_t Voltage2PercentageTable[][7][2] = {
 	[BATTERY_TYPE_1600_MAH] = {
@@ -93,12 +110,93 @@ unsigned int BATTERY_VoltsToPercent(const unsigned int voltage_10mV)
 	return 0;
 }
 
+void BATTERY_InitFilter(void)
+{
+	uint16_t Voltage;
+
+	BOARD_ADC_GetBatteryInfo(&Voltage, &gBatteryCurrent);
+	gBatteryFiltered_q8 = (uint32_t)Voltage << 8;
+}
+
+// from the systick interrupt
+void BATTERY_Tick(void)
+{
+	if (gBatteryElapsed_10ms < UINT8_MAX)
+		gBatteryElapsed_10ms++;
+}
+
+// the battery sags under the TX load, the drop seen over each transmission
+// is learned per power level and added back while transmitting, so the level
+// shown doesn't fall and recover with every PTT press, until the first
+// transmission at a power level has been measured the level shown is held
+void BATTERY_Sample(void)
+{
+	uint16_t Voltage;
+
+	BOARD_ADC_GetBatteryInfo(&Voltage, &gBatteryCurrent);
+
+	const uint32_t Sample_q8 = (uint32_t)Voltage << 8;
+	const bool     bTransmit = gCurrentFunction == FUNCTION_TRANSMIT;
+
+	__disable_irq();
+	uint8_t Elapsed_10ms = gBatteryElapsed_10ms;
+	gBatteryElapsed_10ms = 0;
+	__enable_irq();
+
+	if (bTransmit != gBatteryTransmitting) {
+		gBatteryTransmitting = bTransmit;
+
+		if (bTransmit) {
+			gBatteryTxPower        = MIN(gTxVfo->OUTPUT_POWER, OUTPUT_POWER_HIGH);
+			gBatteryRxReference_q8 = gBatteryFiltered_q8;
+			gBatteryTxFiltered_q8  = Sample_q8;
+		}
+		else {
+			uint32_t     *pSag        = &gBatteryTxSag_q8[gBatteryTxPower];
+			const uint8_t Bit         = 1u << gBatteryTxPower;
+			const int32_t Measured_q8 = (gBatteryRxReference_q8 > gBatteryTxFiltered_q8) ?
+				gBatteryRxReference_q8 - gBatteryTxFiltered_q8 : 0;
+
+			if (gBatteryTxSagLearned & Bit)
+				*pSag += (Measured_q8 - (int32_t)*pSag) / 4;
+			else
+				*pSag = Measured_q8;
+
+			gBatteryTxSagLearned |= Bit;
+		}
+	}
+
+	const bool bHold = bTransmit && !(gBatteryTxSagLearned & (1u << gBatteryTxPower));
+
+	for (; Elapsed_10ms > 0; Elapsed_10ms--) {
+		uint32_t Compensated_q8 = Sample_q8;
+		if (bTransmit) {
+			gBatteryTxFiltered_q8 += ((int32_t)Sample_q8 - (int32_t)gBatteryTxFiltered_q8) >> BATTERY_FILTER_SHIFT;
+			Compensated_q8        += gBatteryTxSag_q8[gBatteryTxPower];
+		}
+
+		if (!bHold)
+			gBatteryFiltered_q8 += ((int32_t)Compensated_q8 - (int32_t)gBatteryFiltered_q8) >> BATTERY_FILTER_SHIFT;
+	}
+}
+
+// in raw ADC units, same as BOARD_ADC_GetBatteryInfo()
+uint16_t BATTERY_GetFilteredVoltage(void)
+{
+	return (gBatteryFiltered_q8 + 128) >> 8;
+}
+
 void BATTERY_GetReadings(const bool bDisplayBatteryLevel)
 {
 	const uint8_t  PreviousBatteryLevel = gBatteryDisplayLevel;
-	const uint16_t Voltage              = (gBatteryVoltages[0] + gBatteryVoltages[1] + gBatteryVoltages[2] + gBatteryVoltages[3]) / 4;
+	const uint16_t Voltage              = BATTERY_GetFilteredVoltage();
 
-	gBatteryVoltageAverage = (Voltage * 760) / gBatteryCalibration[3];
+	// the calibration only changes through the menu or UART, keep its reciprocal
+	static FIXED_Divider_t calDiv;
+	if (gBatteryCalibration[3] != 0) {
+		FIXED_SetDivisor(&calDiv, gBatteryCalibration[3]);
+		gBatteryVoltageAverage = FIXED_Divide(Voltage * 760, &calDiv);
+	}
 
 	if(gBatteryVoltageAverage > 890)
 		gBatteryDisplayLevel = 7; // battery overvoltage
@@ -215,6 +313,8 @@ void BATTERY_TimeSlice500ms(void)
 
 	gReducedService = true;
 
+	AUDIO_WaitTone();   // let the double beep finish, power save stops any tone
+
 	FUNCTION_Select(FUNCTION_POWER_SAVE);
 
 	ST7565_HardwareReset();
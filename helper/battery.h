@@ -23,7 +23,6 @@
 extern uint16_t          gBatteryCalibration[6];
 extern uint16_t          gBatteryCurrentVoltage;
 extern uint16_t          gBatteryCurrent;
-extern uint16_t          gBatteryVoltages[4];
 extern uint16_t          gBatteryVoltageAverage;
 extern uint8_t           gBatteryDisplayLevel;
 extern bool              gChargingWithTypeC;
@@ -42,6 +41,10 @@ typedef enum {
 
 
 unsigned int BATTERY_VoltsToPercent(unsigned int voltage_10mV);
+void BATTERY_InitFilter(void);
+void BATTERY_Tick(void);
+void BATTERY_Sample(void);
+uint16_t BATTERY_GetFilteredVoltage(void);
 void BATTERY_GetReadings(bool bDisplayBatteryLevel);
 void BATTERY_TimeSlice500ms(void);
 
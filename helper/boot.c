@@ -19,12 +19,16 @@
 #ifdef ENABLE_AIRCOPY
 	#include "app/aircopy.h"
 #endif
+#include "audio.h"
 #include "bsp/dp32g030/gpio.h"
 #include "driver/bk4819.h"
 #include "driver/keyboard.h"
 #include "driver/gpio.h"
 #include "driver/system.h"
 #include "helper/boot.h"
+#ifdef ENABLE_PROFILING
+	#include "helper/profile.h"
+#endif
 #include "misc.h"
 #include "radio.h"
 #include "settings.h"
@@ -109,3 +113,58 @@ void BOOT_ProcessMode(BOOT_Mode_t Mode)
 		GUI_SelectNextDisplay(DISPLAY_MAIN);
 	}
 }
+
+// boot work that is not needed to start receiving, done one step per 10ms
+// timeslice once the main loop runs, returns false when everything is done
+bool BOOT_DeferredInit(void)
+{
+	static uint8_t step;
+
+	switch (step++)
+	{
+		case 0:
+			// count the number of menu items
+			gMenuListCount = 0;
+			while (MenuList[gMenuListCount].name[0] != '\0') {
+				if(!gF_LOCK && MenuList[gMenuListCount].menu_id == FIRST_HIDDEN_MENU_ITEM)
+					break;
+
+				gMenuListCount++;
+			}
+			break;
+
+		case 1:
+			SETTINGS_LoadRssiCalibration();
+			break;
+
+#ifdef ENABLE_VOICE
+		case 2:
+			if (!gReducedService)
+			{
+				uint8_t Channel;
+
+				AUDIO_SetVoiceID(0, VOICE_ID_WELCOME);
+
+				Channel = gEeprom.ScreenChannel[gEeprom.TX_VFO];
+				if (IS_MR_CHANNEL(Channel))
+				{
+					AUDIO_SetVoiceID(1, VOICE_ID_CHANNEL_MODE);
+					AUDIO_SetDigitVoice(2, Channel + 1);
+				}
+				else if (IS_FREQ_CHANNEL(Channel))
+					AUDIO_SetVoiceID(1, VOICE_ID_FREQUENCY_MODE);
+
+				AUDIO_PlaySingleVoice(0);
+			}
+			break;
+#endif
+
+		default:
+#ifdef ENABLE_PROFILING
+			gProfileCounters[PROFILE_BOOT_DEFERRED_US] = PROFILE_GetTimeUs();
+#endif
+			return false;
+	}
+
+	return true;
+}
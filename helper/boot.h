@@ -17,6 +17,7 @@
 #ifndef HELPER_BOOT_H
 #define HELPER_BOOT_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "driver/keyboard.h"
 
@@ -33,6 +34,7 @@ typedef enum BOOT_Mode_t BOOT_Mode_t;
 
 BOOT_Mode_t BOOT_GetMode(void);
 void BOOT_ProcessMode(BOOT_Mode_t Mode);
+bool BOOT_DeferredInit(void);
 
 #endif
 
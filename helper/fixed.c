@@ -0,0 +1,47 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "helper/fixed.h"
+
+void FIXED_SetDivisor(FIXED_Divider_t *pDivider, uint32_t Divisor)
+{
+	if (pDivider->Divisor == Divisor)
+		return;
+
+	// l = ceil(log2(Divisor))
+	uint8_t l = 0;
+	while ((1u << l) < Divisor)
+		l++;
+
+	// Magic = floor(2^32 * (2^l - Divisor) / Divisor) + 1, by long division,
+	// the remainder stays below Divisor < 2^31 so it never overflows
+	uint32_t r = (1u << l) - Divisor;
+	uint32_t q = 0;
+	for (uint8_t i = 0; i < 32; i++) {
+		r <<= 1;
+		q <<= 1;
+		if (r >= Divisor) {
+			r -= Divisor;
+			q |= 1;
+		}
+	}
+
+	pDivider->Divisor = Divisor;
+	pDivider->Magic   = q + 1;
+	pDivider->Shift1  = (l > 0) ? 1 : 0;
+	pDivider->Shift2  = (l > 0) ? l - 1 : 0;
+}
@@ -0,0 +1,61 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#ifndef HELPER_FIXED_H
+#define HELPER_FIXED_H
+
+#include <stdint.h>
+
+// the Cortex-M0 has no divide instruction, every '/' is a library call
+// dividing bit by bit, a divisor that changes rarely is turned into a
+// multiply by its reciprocal once and reused (Granlund & Montgomery),
+// exact for any 32 bit numerator
+typedef struct {
+	uint32_t Divisor;   // 0 = not set up yet
+	uint32_t Magic;
+	uint8_t  Shift1;
+	uint8_t  Shift2;
+} FIXED_Divider_t;
+
+// 1 <= Divisor < 2^31, cheap when the divisor didn't change
+void FIXED_SetDivisor(FIXED_Divider_t *pDivider, uint32_t Divisor);
+
+// high 32 bits of the 64 bit product, M0 only multiplies 32x32 -> 32
+static inline uint32_t FIXED_MulHi(uint32_t a, uint32_t b)
+{
+	const uint32_t a_lo  = a & 0xFFFF;
+	const uint32_t a_hi  = a >> 16;
+	const uint32_t b_lo  = b & 0xFFFF;
+	const uint32_t b_hi  = b >> 16;
+	const uint32_t hi_lo = a_hi * b_lo;
+	const uint32_t cross = ((a_lo * b_lo) >> 16) + (hi_lo & 0xFFFF) + a_lo * b_hi;
+
+	return a_hi * b_hi + (hi_lo >> 16) + (cross >> 16);
+}
+
+static inline uint32_t FIXED_Divide(uint32_t Numerator, const FIXED_Divider_t *pDivider)
+{
+	const uint32_t t = FIXED_MulHi(Numerator, pDivider->Magic);
+	return (t + ((Numerator - t) >> pDivider->Shift1)) >> pDivider->Shift2;
+}
+
+static inline int32_t FIXED_Saturate(int32_t Value, int32_t Min, int32_t Max)
+{
+	return (Value < Min) ? Min : (Value > Max) ? Max : Value;
+}
+
+#endif
@@ -0,0 +1,162 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "helper/format.h"
+#include "misc.h"
+
+static const uint32_t Powers[] = {
+	1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1
+};
+
+static uint8_t CountDigits(uint32_t Value)
+{
+	uint8_t Digits = ARRAY_SIZE(Powers);
+	while (Digits > 1 && Value < Powers[ARRAY_SIZE(Powers) - Digits])
+		Digits--;
+	return Digits;
+}
+
+// the low Digits digits of Value, most significant first, by repeated
+// subtraction, at most 9 per digit
+static char *PutDigits(char *pString, uint32_t Value, uint8_t Digits)
+{
+	for (uint8_t i = 0; i < ARRAY_SIZE(Powers); i++) {
+		char c = '0';
+		while (Value >= Powers[i]) {
+			Value -= Powers[i];
+			c++;
+		}
+		if (i >= ARRAY_SIZE(Powers) - Digits)
+			*pString++ = c;
+	}
+	return pString;
+}
+
+static char *PutPadded(char *pString, uint32_t Value, uint8_t Digits, uint8_t Width, char Pad)
+{
+	for (; Width > Digits; Width--)
+		*pString++ = Pad;
+	return PutDigits(pString, Value, Digits);
+}
+
+char *FORMAT_Unsigned(char *pString, uint32_t Value, uint8_t Width, char Pad)
+{
+	pString  = PutPadded(pString, Value, CountDigits(Value), Width, Pad);
+	*pString = 0;
+	return pString;
+}
+
+char *FORMAT_Signed(char *pString, int32_t Value, uint8_t Width)
+{
+	if (Value >= 0)
+		return FORMAT_Unsigned(pString, Value, Width, ' ');
+
+	const uint32_t Magnitude = -(uint32_t)Value;
+	const uint8_t  Digits    = CountDigits(Magnitude);
+
+	for (; Width > Digits + 1; Width--)
+		*pString++ = ' ';
+	*pString++ = '-';
+	pString    = PutDigits(pString, Magnitude, Digits);
+	*pString   = 0;
+	return pString;
+}
+
+char *FORMAT_Decimal(char *pString, uint32_t Value, uint8_t Scale, uint8_t Decimals, uint8_t Width, char Pad)
+{
+	char Digits[ARRAY_SIZE(Powers)];
+
+	// all ten digits once, the integer part is whatever precedes the last Scale
+	PutDigits(Digits, Value, ARRAY_SIZE(Digits));
+
+	const uint8_t Point = ARRAY_SIZE(Digits) - Scale;
+	uint8_t       First = 0;
+	while (First < Point - 1 && Digits[First] == '0')
+		First++;
+
+	for (uint8_t n = Point - First; Width > n; Width--)
+		*pString++ = Pad;
+	for (uint8_t i = First; i < Point; i++)
+		*pString++ = Digits[i];
+
+	if (Decimals > Scale)
+		Decimals = Scale;
+	if (Decimals > 0) {
+		*pString++ = '.';
+		for (uint8_t i = 0; i < Decimals; i++)
+			*pString++ = Digits[Point + i];
+	}
+
+	*pString = 0;
+	return pString;
+}
+
+char *FORMAT_Frequency(char *pString, uint32_t Frequency, uint8_t Decimals, uint8_t Width, char Pad)
+{
+	return FORMAT_Decimal(pString, Frequency, 5, Decimals, Width, Pad);
+}
+
+char *FORMAT_Dbm(char *pString, int32_t Dbm)
+{
+	pString = FORMAT_Signed(pString, Dbm, 0);
+	*pString++ = ' ';
+	*pString++ = 'd';
+	*pString++ = 'B';
+	*pString++ = 'm';
+	*pString   = 0;
+	return pString;
+}
+
+char *FORMAT_SMeter(char *pString, int16_t Dbm, uint8_t SLevel, uint8_t OverS9)
+{
+	pString    = FORMAT_Signed(pString, Dbm, 4);
+	*pString++ = ' ';
+
+	if (OverS9 == 0) {
+		*pString++ = 'S';
+		return FORMAT_Unsigned(pString, SLevel, 0, ' ');
+	}
+
+	*pString++ = ' ';
+	return FORMAT_Unsigned(pString, OverS9, 2, ' ');
+}
+
+char *FORMAT_Percent(char *pString, uint8_t Percent)
+{
+	pString    = FORMAT_Unsigned(pString, Percent, 0, ' ');
+	*pString++ = '%';
+	*pString   = 0;
+	return pString;
+}
+
+char *FORMAT_Channel(char *pString, const char *pPrefix, uint16_t Number, uint8_t Width)
+{
+	while (*pPrefix)
+		*pString++ = *pPrefix++;
+	return FORMAT_Unsigned(pString, Number, Width, '0');
+}
+
+char *FORMAT_DcsCode(char *pString, uint16_t Code, bool bInverted)
+{
+	*pString++ = 'D';
+	*pString++ = '0' + ((Code >> 6) & 7);
+	*pString++ = '0' + ((Code >> 3) & 7);
+	*pString++ = '0' + (Code & 7);
+	*pString++ = bInverted ? 'I' : 'N';
+	*pString   = 0;
+	return pString;
+}
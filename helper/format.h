@@ -0,0 +1,57 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#ifndef HELPER_FORMAT_H
+#define HELPER_FORMAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// fixed purpose number formatters for the display paths, no varargs and no
+// division, each writes a terminated string and returns a pointer to the
+// terminator so calls can be chained into one buffer
+
+// "%*u", padded on the left with Pad (' ' or '0') up to Width characters
+char *FORMAT_Unsigned(char *pString, uint32_t Value, uint8_t Width, char Pad);
+
+// "%*d", space padded
+char *FORMAT_Signed(char *pString, int32_t Value, uint8_t Width);
+
+// Value with its last Scale digits after the point, e.g. Scale 2 gives
+// "%*u.%02u"; only the first Decimals of those digits are written
+char *FORMAT_Decimal(char *pString, uint32_t Value, uint8_t Scale, uint8_t Decimals, uint8_t Width, char Pad);
+
+// Frequency in 10Hz units as MHz, "%*u.%05u" when Decimals is 5
+char *FORMAT_Frequency(char *pString, uint32_t Frequency, uint8_t Decimals, uint8_t Width, char Pad);
+
+// "%d dBm"
+char *FORMAT_Dbm(char *pString, int32_t Dbm);
+
+// the RSSI bar text, "%4d S%u", or "%4d  %2u" with the dB over S9 when
+// OverS9 isn't 0
+char *FORMAT_SMeter(char *pString, int16_t Dbm, uint8_t SLevel, uint8_t OverS9);
+
+// "%u%%"
+char *FORMAT_Percent(char *pString, uint8_t Percent);
+
+// Prefix followed by the channel number zero padded to Width, e.g. "CH-%03u"
+char *FORMAT_Channel(char *pString, const char *pPrefix, uint16_t Number, uint8_t Width);
+
+// a DCS code as it is written, "D%03oN", or "D%03oI" when inverted
+char *FORMAT_DcsCode(char *pString, uint16_t Code, bool bInverted);
+
+#endif
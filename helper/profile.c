@@ -0,0 +1,95 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "ARMCM0.h"
+#include "driver/systick.h"
+#include "helper/profile.h"
+
+uint32_t gProfileCounters[PROFILE_N_ELEM];
+
+static volatile uint32_t gProfileTime_us;
+
+void PROFILE_Tick(uint8_t elapsed_10ms)
+{
+	gProfileTime_us += elapsed_10ms * 10000u;
+}
+
+uint32_t PROFILE_GetTimeUs(void)
+{
+	uint32_t time_us;
+	uint32_t period_10ms;
+	uint32_t value;
+
+	do {
+		time_us     = gProfileTime_us;
+		period_10ms = SYSTICK_GetPeriod_10ms();
+		value       = SysTick->VAL;
+	} while (time_us != gProfileTime_us);
+
+	// the counter runs down from the start of the current period
+	return time_us + period_10ms * 10000u - (value + 1) / SYSTICK_GetTickMultiplier();
+}
+
+// residency counters are kept in ms, the sub ms remainders carried over
+static void AddResidency(PROFILE_Counter_t counter, uint16_t *pRemainder_us, uint32_t time_us)
+{
+	time_us += *pRemainder_us;
+	gProfileCounters[counter] += time_us / 1000;
+	*pRemainder_us = time_us % 1000;
+}
+
+void PROFILE_AddIdleTime(uint32_t start_us, bool bRadioAsleep)
+{
+	static uint32_t window_start_us;
+	static uint32_t idle_us;
+	static uint16_t sleep_remainder_us;
+	static uint16_t radio_sleep_remainder_us;
+
+	const uint32_t now_us = PROFILE_GetTimeUs();
+
+	idle_us += now_us - start_us;
+
+	AddResidency(PROFILE_SLEEP_MS, &sleep_remainder_us, now_us - start_us);
+	if (bRadioAsleep)
+		AddResidency(PROFILE_RADIO_SLEEP_MS, &radio_sleep_remainder_us, now_us - start_us);
+
+	if (now_us - window_start_us >= 1000000) {
+		gProfileCounters[PROFILE_IDLE_PERCENT] = idle_us / ((now_us - window_start_us) / 100);
+		window_start_us = now_us;
+		idle_us         = 0;
+	}
+}
+
+void PROFILE_AddLoopTime(uint32_t start_us)
+{
+	static uint32_t window_start_us;
+	static uint32_t longest_us;
+
+	const uint32_t now_us  = PROFILE_GetTimeUs();
+	const uint32_t pass_us = now_us - start_us;
+
+	if (pass_us > longest_us)
+		longest_us = pass_us;
+	if (pass_us > gProfileCounters[PROFILE_LOOP_STALL_MAX_US])
+		gProfileCounters[PROFILE_LOOP_STALL_MAX_US] = pass_us;
+
+	if (now_us - window_start_us >= 1000000) {
+		gProfileCounters[PROFILE_LOOP_STALL_US] = longest_us;
+		window_start_us = now_us;
+		longest_us      = 0;
+	}
+}
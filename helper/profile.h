@@ -0,0 +1,58 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#ifndef HELPER_PROFILE_H
+#define HELPER_PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+	PROFILE_BOOT_TO_RX_US = 0,     // reset until the init work is done, before the welcome screen and password waits
+	PROFILE_BOOT_DEFERRED_US,      // reset until the deferred boot work is done
+	PROFILE_NAME_CACHE_HITS,       // channel name lookups served from RAM
+	PROFILE_NAME_CACHE_MISSES,     // channel name lookups read from the EEPROM
+	PROFILE_DISPLAY_MAIN_US,       // last full redraw of the main screen
+	PROFILE_DISPLAY_MENU_US,       // last full redraw of the menu
+	PROFILE_IDLE_PERCENT,          // main loop time spent in WFI over the last second
+	PROFILE_SLEEP_MS,              // total time in WFI
+	PROFILE_RADIO_SLEEP_MS,        // total time in WFI while the BK4819 sleeps in battery save
+	PROFILE_KEY_TO_ACTION_US,      // last key, first edge until its handler returned
+	PROFILE_PTT_TO_TX_US,          // last PTT press, first edge until the transmitter was on
+	PROFILE_LOOP_STALL_US,         // longest main loop pass over the last second
+	PROFILE_LOOP_STALL_MAX_US,     // longest main loop pass since reset
+	PROFILE_VOX_TO_TX_US,          // last VOX key up, voice event latched until the transmitter was on
+	PROFILE_TX_KEY_UP_US,          // last RADIO_SetTxParameters, RX off until the PA was biased
+	PROFILE_SCAN_FREQ_HIT_MS,      // last CTCSS/DCS scanner run, start until the tone detectors were tuned to the candidate
+	PROFILE_SCAN_FREQ_LOCK_MS,     // last CTCSS/DCS scanner run, start until the frequency was taken
+	PROFILE_SCAN_CSS_MS,           // last CTCSS/DCS scanner run, start until the tone/code was taken
+	PROFILE_SCAN_CHANNELS_PER_S,   // channel/frequency scan hops over the last second of scanning
+	PROFILE_N_ELEM
+} PROFILE_Counter_t;
+
+extern uint32_t gProfileCounters[PROFILE_N_ELEM];
+
+// called from the systick interrupt
+void     PROFILE_Tick(uint8_t elapsed_10ms);
+// microseconds since reset
+uint32_t PROFILE_GetTimeUs(void);
+// main loop slept from start_us until now
+void     PROFILE_AddIdleTime(uint32_t start_us, bool bRadioAsleep);
+// main loop pass, APP_Update and the timeslices, ran from start_us until now
+void     PROFILE_AddLoopTime(uint32_t start_us);
+
+#endif
@@ -0,0 +1,84 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <stdbool.h>
+
+#include "driver/bk4819.h"
+#include "helper/rssi.h"
+
+static volatile uint32_t gRssiTick_10ms;
+static RSSI_Sample_t     gRssiSample;
+static bool              gRssiValid;
+static bool              gRssiHistoryValid;
+
+void RSSI_Tick(void)
+{
+	gRssiTick_10ms++;
+}
+
+const RSSI_Sample_t *RSSI_Read(void)
+{
+	const uint16_t Rssi = BK4819_GetRSSI();
+
+	gRssiSample.ExNoise = BK4819_GetExNoiceIndicator();
+	gRssiSample.Glitch  = BK4819_GetGlitchIndicator();
+	gRssiSample.Rssi    = Rssi;
+
+	// the history has an entry per tick, the ticks nobody read on since the
+	// last reading get this one, repeated reads within a tick replace it
+	const uint32_t Now     = gRssiTick_10ms;
+	uint32_t       Elapsed = Now - gRssiSample.Timestamp_10ms;
+	if (!gRssiHistoryValid || Elapsed > RSSI_HISTORY_SIZE)
+		Elapsed = RSSI_HISTORY_SIZE;
+
+	for (; Elapsed > 0; Elapsed--) {
+		gRssiSample.HistoryIndex = (gRssiSample.HistoryIndex + 1) % RSSI_HISTORY_SIZE;
+		gRssiSample.History[gRssiSample.HistoryIndex] = Rssi;
+	}
+	gRssiSample.History[gRssiSample.HistoryIndex] = Rssi;
+
+	gRssiSample.Timestamp_10ms = Now;
+	gRssiValid                 = true;
+	gRssiHistoryValid          = true;
+
+	return &gRssiSample;
+}
+
+const RSSI_Sample_t *RSSI_Get(void)
+{
+	if (gRssiValid && gRssiSample.Timestamp_10ms == gRssiTick_10ms)
+		return &gRssiSample;
+
+	return RSSI_Read();
+}
+
+void RSSI_Invalidate(void)
+{
+	gRssiValid        = false;
+	gRssiHistoryValid = false;
+}
+
+uint16_t RSSI_GetAverage(void)
+{
+	const RSSI_Sample_t *pSample = RSSI_Get();
+	uint32_t             Sum     = 0;
+
+	for (uint8_t i = 0; i < RSSI_HISTORY_SIZE; i++)
+		Sum += pSample->History[i];
+
+	return Sum / RSSI_HISTORY_SIZE;
+}
@@ -0,0 +1,52 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#ifndef HELPER_RSSI_H
+#define HELPER_RSSI_H
+
+#include <assert.h>
+#include <stdint.h>
+
+// RSSI samples kept for averaging, a power of two so the mean is a shift
+#define RSSI_HISTORY_SIZE 4
+
+static_assert((RSSI_HISTORY_SIZE & (RSSI_HISTORY_SIZE - 1)) == 0);
+
+typedef struct {
+	uint32_t Timestamp_10ms;             // tick the sample was read on
+	uint16_t Rssi;                       // REG_67, 0.5dB steps
+	uint8_t  ExNoise;                    // REG_65
+	uint8_t  Glitch;                     // REG_63
+	uint16_t History[RSSI_HISTORY_SIZE]; // RSSI of the last ticks, a tick without a read holds the next reading
+	uint8_t  HistoryIndex;
+} RSSI_Sample_t;
+
+// called from the systick interrupt, ages the sample
+void RSSI_Tick(void);
+
+// the signal registers as of this tick, read over SPI only once per tick
+const RSSI_Sample_t *RSSI_Get(void);
+// read the registers now, for callers that just retuned and wait for settling
+const RSSI_Sample_t *RSSI_Read(void);
+// the front end changed (frequency, gain), the next RSSI_Get reads again
+void RSSI_Invalidate(void);
+
+// mean RSSI over the last RSSI_HISTORY_SIZE ticks, restarts from the first
+// reading whenever the front end changes
+uint16_t RSSI_GetAverage(void);
+
+#endif
@@ -0,0 +1,186 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "driver/bk4819.h"
+#include "helper/rssi_trace.h"
+
+// capture logs the signal registers every 10ms together with the interrupt
+// flags the app fetched in between, replay feeds such a trace back through
+// BK4819_ReadRegister so the AM fix, squelch interrupts and the spectrum see
+// the recorded signal conditions instead of the live ones
+
+static RSSI_TRACE_Entry_t gRssiTrace[RSSI_TRACE_SIZE];
+static uint8_t            gRssiTraceHead;
+uint8_t                   gRssiTraceCount;
+
+static volatile RSSI_TRACE_Mode_t gRssiTraceMode;
+static volatile uint32_t          gRssiTraceTick_10ms;
+static uint32_t                   gRssiTraceFrequency;
+static uint16_t                   gRssiTraceReg02;
+
+// replay state, the cursor is advanced by the systick interrupt only
+static volatile uint8_t           gReplayCursor;
+static volatile uint32_t          gReplayElapsed_10ms;
+static uint8_t                    gReplayConsumed;
+
+const RSSI_TRACE_Entry_t *RSSI_TRACE_GetEntry(uint8_t Index)
+{
+	return &gRssiTrace[(gRssiTraceHead + RSSI_TRACE_SIZE - gRssiTraceCount + Index) % RSSI_TRACE_SIZE];
+}
+
+// interrupt flags of the replayed entries the app has not fetched yet
+static uint16_t GetPendingInterrupts(uint8_t cursor)
+{
+	uint16_t flags = 0;
+
+	for (uint8_t i = gReplayConsumed + 1; i <= cursor && i < gRssiTraceCount; i++)
+		flags |= RSSI_TRACE_GetEntry(i)->Reg02;
+
+	return flags;
+}
+
+void RSSI_TRACE_LoadEntry(uint8_t Index, const RSSI_TRACE_Entry_t *pEntry)
+{
+	if (Index >= RSSI_TRACE_SIZE)
+		return;
+
+	gRssiTraceMode = RSSI_TRACE_OFF;
+
+	if (Index == 0)
+		gRssiTraceCount = 0;
+
+	gRssiTrace[Index] = *pEntry;
+
+	if (gRssiTraceCount <= Index)
+		gRssiTraceCount = Index + 1;
+
+	gRssiTraceHead = gRssiTraceCount % RSSI_TRACE_SIZE;
+}
+
+RSSI_TRACE_Mode_t RSSI_TRACE_GetMode(void)
+{
+	return gRssiTraceMode;
+}
+
+void RSSI_TRACE_SetMode(RSSI_TRACE_Mode_t Mode)
+{
+	gRssiTraceMode = RSSI_TRACE_OFF;
+
+	if (Mode == RSSI_TRACE_CAPTURE) {
+		gRssiTraceHead  = 0;
+		gRssiTraceCount = 0;
+		gRssiTraceReg02 = 0;
+	}
+	else if (Mode == RSSI_TRACE_REPLAY) {
+		if (gRssiTraceCount == 0)
+			return;
+
+		gReplayCursor       = 0;
+		gReplayElapsed_10ms = 0;
+		gReplayConsumed     = 0xFF; // the first entry's interrupts are still pending
+	}
+
+	gRssiTraceMode = Mode;
+}
+
+void RSSI_TRACE_Tick(void)
+{
+	gRssiTraceTick_10ms++;
+
+	if (gRssiTraceMode != RSSI_TRACE_REPLAY)
+		return;
+
+	const uint32_t start = RSSI_TRACE_GetEntry(0)->Timestamp_10ms;
+	uint8_t        cursor = gReplayCursor;
+
+	gReplayElapsed_10ms++;
+
+	while (cursor + 1 < gRssiTraceCount && RSSI_TRACE_GetEntry(cursor + 1)->Timestamp_10ms - start <= gReplayElapsed_10ms)
+		cursor++;
+
+	if (cursor + 1 >= gRssiTraceCount && RSSI_TRACE_GetEntry(cursor)->Timestamp_10ms - start < gReplayElapsed_10ms) {
+		gRssiTraceMode = RSSI_TRACE_OFF;  // end of trace, back to the live registers
+		return;
+	}
+
+	gReplayCursor = cursor;
+}
+
+void RSSI_TRACE_TimeSlice10ms(void)
+{
+	if (gRssiTraceMode != RSSI_TRACE_CAPTURE)
+		return;
+
+	RSSI_TRACE_Entry_t *pEntry = &gRssiTrace[gRssiTraceHead];
+
+	pEntry->Timestamp_10ms = gRssiTraceTick_10ms;
+	pEntry->Frequency      = gRssiTraceFrequency;
+	pEntry->Reg67          = BK4819_ReadRegister(BK4819_REG_67);
+	pEntry->Reg65          = BK4819_ReadRegister(BK4819_REG_65);
+	pEntry->Reg63          = BK4819_ReadRegister(BK4819_REG_63);
+	pEntry->Reg02          = gRssiTraceReg02;
+
+	gRssiTraceReg02 = 0;
+	gRssiTraceHead  = (gRssiTraceHead + 1) % RSSI_TRACE_SIZE;
+
+	if (gRssiTraceCount < RSSI_TRACE_SIZE)
+		gRssiTraceCount++;
+}
+
+uint16_t RSSI_TRACE_FilterRegister(uint8_t Register, uint16_t Value)
+{
+	if (gRssiTraceMode == RSSI_TRACE_CAPTURE) {
+		if (Register == BK4819_REG_02)
+			gRssiTraceReg02 |= Value;
+		return Value;
+	}
+
+	if (gRssiTraceMode != RSSI_TRACE_REPLAY)
+		return Value;
+
+	const uint8_t             cursor = gReplayCursor;
+	const RSSI_TRACE_Entry_t *pEntry = RSSI_TRACE_GetEntry(cursor);
+
+	switch (Register) {
+		case BK4819_REG_67:
+			return pEntry->Reg67;
+
+		case BK4819_REG_65:
+			return pEntry->Reg65;
+
+		case BK4819_REG_63:
+			return pEntry->Reg63;
+
+		case BK4819_REG_0C:
+			// interrupt request only while traced interrupts are pending
+			return (Value & ~1u) | (GetPendingInterrupts(cursor) != 0);
+
+		case BK4819_REG_02:
+			// hand over everything that happened since the last fetch
+			Value = GetPendingInterrupts(cursor);
+			gReplayConsumed = cursor;
+			return Value;
+
+		default:
+			return Value;
+	}
+}
+
+void RSSI_TRACE_SetFrequency(uint32_t Frequency)
+{
+	gRssiTraceFrequency = Frequency;
+}
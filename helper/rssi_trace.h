@@ -0,0 +1,60 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#ifndef HELPER_RSSI_TRACE_H
+#define HELPER_RSSI_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// number of 10ms samples kept in RAM
+#define RSSI_TRACE_SIZE 64
+
+typedef enum {
+	RSSI_TRACE_OFF = 0,
+	RSSI_TRACE_CAPTURE,
+	RSSI_TRACE_REPLAY
+} RSSI_TRACE_Mode_t;
+
+typedef struct {
+	uint32_t Timestamp_10ms;
+	uint32_t Frequency;
+	uint16_t Reg67;   // RSSI
+	uint16_t Reg65;   // ex-noise indicator
+	uint16_t Reg63;   // glitch indicator
+	uint16_t Reg02;   // interrupt flags seen since the previous sample
+} RSSI_TRACE_Entry_t;
+
+extern uint8_t gRssiTraceCount;
+
+RSSI_TRACE_Mode_t RSSI_TRACE_GetMode(void);
+void RSSI_TRACE_SetMode(RSSI_TRACE_Mode_t Mode);
+
+// called from the systick interrupt, advances the replay cursor
+void RSSI_TRACE_Tick(void);
+// called from the 10ms timeslice, records one capture sample
+void RSSI_TRACE_TimeSlice10ms(void);
+
+// hooks used by the BK4819 driver, the filter returns the value the caller
+// gets to see, replay substitutes the traced signal/interrupt registers
+uint16_t RSSI_TRACE_FilterRegister(uint8_t Register, uint16_t Value);
+void     RSSI_TRACE_SetFrequency(uint32_t Frequency);
+
+const RSSI_TRACE_Entry_t *RSSI_TRACE_GetEntry(uint8_t Index);
+void RSSI_TRACE_LoadEntry(uint8_t Index, const RSSI_TRACE_Entry_t *pEntry);
+
+#endif
@@ -0,0 +1,103 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stddef.h>
+
+#include "helper/task.h"
+#include "misc.h"
+
+typedef struct {
+	TASK_Func_t    Func;   // NULL = free
+	TASK_Context_t Context;
+} TASK_Slot_t;
+
+// more than there are tasks, TASK_Start failing is a bug to fix here
+static TASK_Slot_t gTasks[4];
+
+static TASK_Slot_t *FindTask(TASK_Func_t pFunc)
+{
+	for (unsigned int i = 0; i < ARRAY_SIZE(gTasks); i++)
+		if (gTasks[i].Func == pFunc)
+			return &gTasks[i];
+
+	return NULL;
+}
+
+static void RunTask(TASK_Slot_t *pSlot)
+{
+	const TASK_Func_t pFunc = pSlot->Func;
+
+	// it may have stopped itself, or been started again in another slot
+	if (pFunc(&pSlot->Context) && pSlot->Func == pFunc)
+		pSlot->Func = NULL;
+}
+
+bool TASK_Start(TASK_Func_t pFunc)
+{
+	if (pFunc == NULL)
+		return false;
+
+	if (FindTask(pFunc) != NULL)
+		return true;
+
+	TASK_Slot_t *pSlot = FindTask(NULL);
+	if (pSlot == NULL)
+		return false;
+
+	pSlot->Context.Line      = 0;
+	pSlot->Context.Wait_10ms = 0;
+	pSlot->Func              = pFunc;
+
+	RunTask(pSlot);
+
+	return true;
+}
+
+void TASK_Stop(TASK_Func_t pFunc)
+{
+	TASK_Slot_t *pSlot = FindTask(pFunc);
+
+	if (pFunc != NULL && pSlot != NULL)
+		pSlot->Func = NULL;
+}
+
+bool TASK_IsRunning(TASK_Func_t pFunc)
+{
+	return pFunc != NULL && FindTask(pFunc) != NULL;
+}
+
+bool TASK_IsBusy(void)
+{
+	for (unsigned int i = 0; i < ARRAY_SIZE(gTasks); i++)
+		if (gTasks[i].Func != NULL)
+			return true;
+
+	return false;
+}
+
+void TASK_Tick(void)
+{
+	for (unsigned int i = 0; i < ARRAY_SIZE(gTasks); i++)
+		if (gTasks[i].Func != NULL && gTasks[i].Context.Wait_10ms > 0)
+			gTasks[i].Context.Wait_10ms--;
+}
+
+void TASK_Run(void)
+{
+	for (unsigned int i = 0; i < ARRAY_SIZE(gTasks); i++)
+		if (gTasks[i].Func != NULL && gTasks[i].Context.Wait_10ms == 0)
+			RunTask(&gTasks[i]);
+}
@@ -0,0 +1,81 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef HELPER_TASK_H
+#define HELPER_TASK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Stackless tasks for the long chip sequences, in the protothread style.
+// The body is a switch on the line it last yielded at, so locals don't
+// survive a yield, keep any state in statics. A task body can't yield from
+// inside a switch of its own.
+
+typedef struct {
+	uint16_t          Line;        // where to resume, 0 = from the top
+	volatile uint16_t Wait_10ms;   // counted down by the systick
+} TASK_Context_t;
+
+// returns true once the task has finished
+typedef bool (*TASK_Func_t)(TASK_Context_t *pTask);
+
+#define TASK_BEGIN(pTask) \
+	switch ((pTask)->Line) { case 0:
+
+#define TASK_END(pTask) \
+	} (pTask)->Line = 0; return true
+
+#define TASK_EXIT(pTask)       \
+	do {                       \
+		(pTask)->Line = 0;     \
+		return true;           \
+	} while (0)
+
+// hand the main loop back for at least ms, the tick that follows may
+// already be due so one more is counted
+#define TASK_YIELD_FOR(pTask, ms)                 \
+	do {                                          \
+		(pTask)->Wait_10ms = ((ms) + 19) / 10;    \
+		(pTask)->Line      = __LINE__;            \
+		return false;                             \
+		case __LINE__:;                           \
+	} while (0)
+
+// checked again every timeslice
+#define TASK_WAIT_UNTIL(pTask, cond)   \
+	do {                               \
+		(pTask)->Line = __LINE__;      \
+		__attribute__((fallthrough));  \
+		case __LINE__:                 \
+		if (!(cond))                   \
+			return false;              \
+	} while (0)
+
+// runs the task up to its first yield, a task already running carries on,
+// false when every slot is taken and the task was not started
+bool TASK_Start(TASK_Func_t pFunc);
+void TASK_Stop(TASK_Func_t pFunc);
+bool TASK_IsRunning(TASK_Func_t pFunc);
+// any task still running, the main loop keeps the 10ms tick for it
+bool TASK_IsBusy(void);
+
+// called from the systick interrupt
+void TASK_Tick(void);
+// called every timeslice, resumes the tasks whose wait is over
+void TASK_Run(void);
+
+#endif
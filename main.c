@@ -29,8 +29,18 @@
 #include "settings.h"
 #include "version.h"
 
+#include "ARMCM0.h"
+
 #include "app/app.h"
+#include "app/chFrScanner.h"
+#ifdef ENABLE_CHANNEL_STATS
+	#include "app/chstats.h"
+#endif
 #include "app/dtmf.h"
+#ifdef ENABLE_FMRADIO
+	#include "app/fm.h"
+#endif
+#include "app/scanner.h"
 #include "bsp/dp32g030/gpio.h"
 #include "bsp/dp32g030/syscon.h"
 
@@ -45,6 +55,10 @@
 
 #include "helper/battery.h"
 #include "helper/boot.h"
+#ifdef ENABLE_PROFILING
+	#include "helper/profile.h"
+#endif
+#include "helper/task.h"
 
 #include "ui/lock.h"
 #include "ui/welcome.h"
@@ -58,6 +72,72 @@ void _putchar(__attribute__((unused)) char c)
 
 }
 
+static uint8_t GetIdleTickPeriod_10ms(void)
+{
+	// tone scripts and tasks step on every 10ms tick
+	if (AUDIO_IsTonePlaying() || TASK_IsBusy())
+		return 1;
+
+	// keys are ignored with reduced service, APP_TimeSlice10ms returns before
+	// CheckKeys so no debounce counts ticks, a coarse tick costs no latency there
+	if (gReducedService)
+		return idle_tick_reduced_service_10ms;
+
+	// the BK4819 sleeps, stretch the tick over the off window but never past
+	// its end, so the RX window still opens on the exact 10ms it's due
+	if (gCurrentFunction == FUNCTION_POWER_SAVE && gRxIdleMode && !gPowerSaveCountdownExpired) {
+		const uint16_t remaining_10ms = gPowerSave_10ms;
+		const uint8_t  running_10ms   = SYSTICK_GetPeriod_10ms();
+
+		if (remaining_10ms > running_10ms)
+			return MIN(remaining_10ms - running_10ms, power_save_idle_tick_max_10ms);
+	}
+
+	return 1;
+}
+
+// the core only runs at full speed while something is timing critical,
+// the idle standby screen and the power save windows manage with less
+static SYSTEM_Clock_t GetRequiredClock(void)
+{
+	if (gCurrentFunction == FUNCTION_TRANSMIT || FUNCTION_IsRx() ||
+	    gScanStateDir != SCAN_OFF || gCssBackgroundScan || SCANNER_IsScanning() ||
+	    SerialConfigInProgress())
+		return SYSTEM_CLOCK_48MHZ;
+
+#ifdef ENABLE_FMRADIO
+	if (gFM_ScanState != FM_SCAN_OFF)
+		return SYSTEM_CLOCK_48MHZ;
+#endif
+
+	if (gReducedService || gCurrentFunction == FUNCTION_POWER_SAVE)
+		return SYSTEM_CLOCK_12MHZ;
+
+	return SYSTEM_CLOCK_24MHZ;
+}
+
+// nothing is scheduled, sleep until the next interrupt
+// everything the main loop does is driven by systick flags, so at worst the
+// CPU wakes up once a tick
+static void WaitForInterrupt(void)
+{
+	SYSTICK_SetPeriod_10ms(GetIdleTickPeriod_10ms());
+
+	__disable_irq();
+	if (!gNextTimeslice) {
+#ifdef ENABLE_PROFILING
+		const bool     bRadioAsleep = gCurrentFunction == FUNCTION_POWER_SAVE && gRxIdleMode;
+		const uint32_t start_us     = PROFILE_GetTimeUs();
+#endif
+		__WFI();
+		__enable_irq();   // let the pending interrupt run first
+#ifdef ENABLE_PROFILING
+		PROFILE_AddIdleTime(start_us, bRadioAsleep);
+#endif
+	}
+	__enable_irq();
+}
+
 void Main(void)
 {
 	// Enable clock gating of blocks we need
@@ -103,8 +183,11 @@ void Main(void)
 
 	RADIO_SetupRegisters(true);
 
-	for (unsigned int i = 0; i < ARRAY_SIZE(gBatteryVoltages); i++)
-		BOARD_ADC_GetBatteryInfo(&gBatteryVoltages[i], &gBatteryCurrent);
+	BATTERY_InitFilter();
+
+#ifdef ENABLE_CHANNEL_STATS
+	CHSTATS_Init();
+#endif
 
 	BATTERY_GetReadings(false);
 
@@ -112,6 +195,11 @@ void Main(void)
 	AM_fix_init();
 #endif
 
+#ifdef ENABLE_PROFILING
+	// the init work is done, what follows waits on the user
+	gProfileCounters[PROFILE_BOOT_TO_RX_US] = PROFILE_GetTimeUs();
+#endif
+
 	const BOOT_Mode_t  BootMode = BOOT_GetMode();
 
 	if (BootMode == BOOT_MODE_F_LOCK)
@@ -119,15 +207,6 @@ void Main(void)
 		gF_LOCK = true;            // flag to say include the hidden menu items
 	}
 
-	// count the number of menu items
-	gMenuListCount = 0;
-	while (MenuList[gMenuListCount].name[0] != '\0') {
-		if(!gF_LOCK && MenuList[gMenuListCount].menu_id == FIRST_HIDDEN_MENU_ITEM)
-			break;
-
-		gMenuListCount++;
-	}
-
 	// wait for user to release all butts before moving on
 	if (!GPIO_CheckBit(&GPIOC->DATA, GPIOC_PIN_PTT) ||
 	     KEYBOARD_Poll() != KEY_INVALID ||
@@ -174,8 +253,10 @@ void Main(void)
 					break;
 				}
 #ifdef ENABLE_BOOT_BEEPS
-				if ((boot_counter_10ms % 25) == 0)
+				if ((boot_counter_10ms % 25) == 0) {
 					AUDIO_PlayBeep(BEEP_880HZ_40MS_OPTIONAL);
+					AUDIO_WaitTone();   // the main loop isn't running yet
+				}
 #endif
 			}
 		}
@@ -195,34 +276,27 @@ void Main(void)
 
 		gUpdateStatus = true;
 
-#ifdef ENABLE_VOICE
-		{
-			uint8_t Channel;
-
-			AUDIO_SetVoiceID(0, VOICE_ID_WELCOME);
-
-			Channel = gEeprom.ScreenChannel[gEeprom.TX_VFO];
-			if (IS_MR_CHANNEL(Channel))
-			{
-				AUDIO_SetVoiceID(1, VOICE_ID_CHANNEL_MODE);
-				AUDIO_SetDigitVoice(2, Channel + 1);
-			}
-			else if (IS_FREQ_CHANNEL(Channel))
-				AUDIO_SetVoiceID(1, VOICE_ID_FREQUENCY_MODE);
-
-			AUDIO_PlaySingleVoice(0);
-		}
-#endif
-
 #ifdef ENABLE_NOAA
 		RADIO_ConfigureNOAA();
 #endif
 	}
 
+	bool bDeferredInit = true;
+
 	while (true) {
+#ifdef ENABLE_PROFILING
+		const uint32_t pass_us = PROFILE_GetTimeUs();
+#endif
 		APP_Update();
 
-		if (gNextTimeslice) {
+		const bool bTimeslice = gNextTimeslice;
+		if (bTimeslice) {
+			// the clock can change here, the systick count in progress is rescaled
+			SYSTEM_SetClock(GetRequiredClock());
+
+			// one step per timeslice: the menu item count, the RSSI calibration, the welcome voice
+			if (bDeferredInit)
+				bDeferredInit = BOOT_DeferredInit();
 
 			APP_TimeSlice10ms();
 
@@ -230,5 +304,14 @@ void Main(void)
 				APP_TimeSlice500ms();
 			}
 		}
+
+#ifdef ENABLE_PROFILING
+		PROFILE_AddLoopTime(pass_us);
+#endif
+
+		if (!bTimeslice) {
+			// only after APP_Update had a chance to act on what the timeslice found
+			WaitForInterrupt();
+		}
 	}
 }
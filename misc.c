@@ -43,6 +43,10 @@ const uint16_t    key_repeat_10ms                  =    80 / 10;   // 80ms .. MU
 const uint16_t    key_debounce_10ms                =    20 / 10;   // 20ms
 
 const uint8_t     scan_delay_10ms                  =   210 / 10;   // 210ms
+const uint8_t     scan_freq_hits                   =     3;        // frequency scan results in a row within the tolerance before the frequency is taken
+const uint8_t     scan_freq_tolerance_10Hz         =   100;        // 1kHz
+const uint8_t     scan_ctcss_hits                  =     3;        // matching CTCSS readings before the tone is taken
+const uint8_t     scan_cdcss_hits                  =     1;        // a DCS reading already passed the Golay check
 
 const uint16_t    dual_watch_count_after_tx_10ms   =  3600 / 10;   // 3.6 sec after TX ends
 const uint16_t    dual_watch_count_after_rx_10ms   =  1000 / 10;   // 1 sec after RX ends ?
@@ -62,13 +66,36 @@ const uint16_t    scan_pause_delay_in_5_10ms       =  1000 / 10;   // 1 sec
 const uint16_t    scan_pause_delay_in_6_10ms       =   100 / 10;   // 100ms
 const uint16_t    scan_pause_delay_in_7_10ms       =  3600 / 10;   // 3.6 seconds
 
+#ifdef ENABLE_FASTER_CHANNEL_SCAN
+	const uint8_t     scan_dwell_min_10ms              =    90 / 10;   // shortest measured dwell per channel, the old fixed one, <= 60ms missed signals
+	const uint8_t     scan_dwell_max_10ms              =   200 / 10;   // longest measured dwell per channel
+	const uint8_t     scan_dwell_margin_10ms           =    30 / 10;   // squelch open delay (REG_4E) after the signal settled
+	const uint8_t     scan_early_exit_10ms             =    30 / 10;   // earliest hop on a quiet channel once its RSSI settled
+	const uint8_t     scan_early_exit_margin           =    20;        // 10dB below the squelch open level is quiet
+	const uint8_t     scan_rssi_settle_delta           =     6;        // 3dB between two ticks is settled
+	const uint8_t     scan_noise_settle_delta          =     4;        // ex-noise (REG_65) change between two ticks that is settled
+	const uint8_t     scan_glitch_settle_delta         =    10;        // glitch (REG_63) change between two ticks that is settled
+#endif
+
 const uint16_t    battery_save_count_10ms          = 10000 / 10;   // 10 seconds
 
 const uint16_t    power_save1_10ms                 =   100 / 10;   // 100ms
 const uint16_t    power_save2_10ms                 =   200 / 10;   // 200ms
 
+const uint8_t     idle_tick_reduced_service_10ms   =   100 / 10;   // 100ms systick while keys are ignored
+
+// battery save duty cycle per BATTERY_SAVE level (off, 1:1 .. 1:4)
+const uint16_t    power_save_rx_10ms[5]            = {0, 100 / 10, 100 / 10, 100 / 10, 100 / 10};  // RX window
+const uint16_t    power_save_sleep_10ms[5]         = {0, 100 / 10, 200 / 10, 300 / 10, 400 / 10};  // BK4819 asleep
+const uint8_t     power_save_idle_tick_max_10ms    =    40 / 10;   // 40ms longest systick while the BK4819 sleeps, keys are polled at this rate
+
 #ifdef ENABLE_VOX
 	const uint16_t    vox_stop_count_down_10ms         =  1000 / 10;   // 1 second
+	const uint8_t     vox_key_up_delay_10ms            =   100 / 10;   // voice held this long before keying up, shorter clips less of the first syllable, longer rejects more clicks
+#endif
+
+#ifdef ENABLE_CSS_DECODE
+	const uint8_t     css_decode_poll_10ms             =   100 / 10;   // CxCSS detector readback while receiving, two matching reads show the code
 #endif
 
 const uint16_t    NOAA_countdown_10ms              =  5000 / 10;   // 5 seconds
@@ -154,7 +181,6 @@ int16_t           gVFO_RSSI[2];
 uint8_t           gVFO_RSSI_bar_level[2];
 
 uint8_t           gReducedService;
-uint8_t           gBatteryVoltageIndex;
 bool     		  gCssBackgroundScan;
 
 volatile bool     gScheduleScanListen = true;
@@ -103,14 +103,29 @@ extern const uint16_t        key_repeat_10ms;
 extern const uint16_t        key_debounce_10ms;
 
 extern const uint8_t         scan_delay_10ms;
+extern const uint8_t         scan_freq_hits;
+extern const uint8_t         scan_freq_tolerance_10Hz;
+extern const uint8_t         scan_ctcss_hits;
+extern const uint8_t         scan_cdcss_hits;
 
 extern const uint16_t        battery_save_count_10ms;
 
 extern const uint16_t        power_save1_10ms;
 extern const uint16_t        power_save2_10ms;
 
+extern const uint8_t         idle_tick_reduced_service_10ms;
+
+extern const uint16_t        power_save_rx_10ms[5];
+extern const uint16_t        power_save_sleep_10ms[5];
+extern const uint8_t         power_save_idle_tick_max_10ms;
+
 #ifdef ENABLE_VOX
 	extern const uint16_t    vox_stop_count_down_10ms;
+	extern const uint8_t     vox_key_up_delay_10ms;
+#endif
+
+#ifdef ENABLE_CSS_DECODE
+	extern const uint8_t     css_decode_poll_10ms;
 #endif
 
 extern const uint16_t        NOAA_countdown_10ms;
@@ -135,6 +150,17 @@ extern const uint16_t        scan_pause_delay_in_5_10ms;
 extern const uint16_t        scan_pause_delay_in_6_10ms;
 extern const uint16_t        scan_pause_delay_in_7_10ms;
 
+#ifdef ENABLE_FASTER_CHANNEL_SCAN
+	extern const uint8_t     scan_dwell_min_10ms;
+	extern const uint8_t     scan_dwell_max_10ms;
+	extern const uint8_t     scan_dwell_margin_10ms;
+	extern const uint8_t     scan_early_exit_10ms;
+	extern const uint8_t     scan_early_exit_margin;
+	extern const uint8_t     scan_rssi_settle_delta;
+	extern const uint8_t     scan_noise_settle_delta;
+	extern const uint8_t     scan_glitch_settle_delta;
+#endif
+
 //extern const uint16_t        gMax_bat_v;
 //extern const uint16_t        gMin_bat_v;
 
@@ -225,7 +251,6 @@ extern uint8_t               gVFO_RSSI_bar_level[2];
 
 // battery critical, limit functionality to minimum
 extern uint8_t               gReducedService;
-extern uint8_t               gBatteryVoltageIndex;
 
 // we are searching CTCSS/DCS inside RX ctcss/dcs menu
 extern bool         gCssBackgroundScan;
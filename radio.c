@@ -32,6 +32,9 @@
 #include "frequencies.h"
 #include "functions.h"
 #include "helper/battery.h"
+#ifdef ENABLE_PROFILING
+	#include "helper/profile.h"
+#endif
 #include "misc.h"
 #include "radio.h"
 #include "settings.h"
@@ -41,6 +44,11 @@ VFO_Info_t    *gTxVfo;
 VFO_Info_t    *gRxVfo;
 VFO_Info_t    *gCurrentVfo;
 DCS_CodeType_t gCurrentCodeType;
+
+#ifdef ENABLE_CSS_DECODE
+DCS_CodeType_t gRxCssDecodeType;
+uint8_t        gRxCssDecodeCode;
+#endif
 VfoState_t     VfoState[2];
 
 const char gModulationStr[MODULATION_UKNOWN][4] = {
@@ -384,6 +392,89 @@ void RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure
 	RADIO_ConfigureSquelchAndOutputPower(pVfo);
 }
 
+// the squelch and TX power calibration, scanning reconfigures the channel on
+// every step, the two VFOs usually need two different entries of each
+typedef struct {
+	uint16_t Address;   // 0 = unused
+	uint8_t  Data[6];
+} CalibrationCache_t;
+
+static CalibrationCache_t gSquelchCache[2];
+static CalibrationCache_t gTxpCache[2];
+
+static const uint8_t *GetCalibration(CalibrationCache_t Cache[2], uint16_t Address, uint8_t Stride, uint8_t Size)
+{
+	if (Cache[0].Address == Address)
+		return Cache[0].Data;
+
+	if (Cache[1].Address != Address) {
+		Cache[1].Address = Address;
+		for (uint8_t i = 0; i < Size; i++)
+			EEPROM_ReadBuffer(Address + i * Stride, &Cache[1].Data[i], 1);
+	}
+
+	// most recent first
+	const CalibrationCache_t Entry = Cache[1];
+	Cache[1] = Cache[0];
+	Cache[0] = Entry;
+
+	return Cache[0].Data;
+}
+
+void RADIO_InvalidateCalibrationCache(void)
+{
+	memset(gSquelchCache, 0, sizeof(gSquelchCache));
+	memset(gTxpCache, 0, sizeof(gTxpCache));
+}
+
+static bool IsTxImageCurrent(const VFO_Info_t *pInfo)
+{
+	const RADIO_TxImage_t *pImage = &pInfo->TxImage;
+
+	return pImage->Regs.Frequency == pInfo->pTX->Frequency   &&
+	       pImage->Bias           == pInfo->TXP_CalculatedSetting &&
+	       pImage->Bandwidth      == pInfo->CHANNEL_BANDWIDTH &&
+	       pImage->CodeType       == pInfo->pTX->CodeType    &&
+	       pImage->Code           == pInfo->pTX->Code;
+}
+
+// everything key up needs that doesn't change until the channel does
+static void PrepareTxImage(VFO_Info_t *pInfo)
+{
+	RADIO_TxImage_t         *pImage    = &pInfo->TxImage;
+	BK4819_FilterBandwidth_t Bandwidth = pInfo->CHANNEL_BANDWIDTH;
+
+	if (Bandwidth != BK4819_FILTER_BW_WIDE && Bandwidth != BK4819_FILTER_BW_NARROW)
+		Bandwidth = BK4819_FILTER_BW_WIDE;
+
+	pImage->Bias      = pInfo->TXP_CalculatedSetting;
+	pImage->Bandwidth = pInfo->CHANNEL_BANDWIDTH;
+	pImage->CodeType  = pInfo->pTX->CodeType;
+	pImage->Code      = pInfo->pTX->Code;
+
+#ifdef ENABLE_AM_FIX
+	BK4819_BuildTxImage(&pImage->Regs, pInfo->pTX->Frequency, Bandwidth, true, pInfo->TXP_CalculatedSetting);
+#else
+	BK4819_BuildTxImage(&pImage->Regs, pInfo->pTX->Frequency, Bandwidth, false, pInfo->TXP_CalculatedSetting);
+#endif
+
+	switch (pInfo->pTX->CodeType)
+	{
+		default:
+		case CODE_TYPE_OFF:
+			break;
+
+		case CODE_TYPE_CONTINUOUS_TONE:
+			BK4819_SetTxImageCTCSS(&pImage->Regs, CTCSS_Options[pInfo->pTX->Code]);
+			break;
+
+		case CODE_TYPE_DIGITAL:
+		case CODE_TYPE_REVERSE_DIGITAL:
+			BK4819_SetTxImageCDCSS(&pImage->Regs, DCS_GetGolayCodeWord(pInfo->pTX->CodeType, pInfo->pTX->Code));
+			break;
+	}
+}
+
 void RADIO_ConfigureSquelchAndOutputPower(VFO_Info_t *pInfo)
 {
 
@@ -407,15 +498,17 @@ void RADIO_ConfigureSquelchAndOutputPower(VFO_Info_t *pInfo)
 	else
 	{	// squelch >= 1
 		Base += gEeprom.SQUELCH_LEVEL;                                        // my eeprom squelch-1
-																			  // VHF   UHF
-		EEPROM_ReadBuffer(Base + 0x00, &pInfo->SquelchOpenRSSIThresh,    1);  //  50    10
-		EEPROM_ReadBuffer(Base + 0x10, &pInfo->SquelchCloseRSSIThresh,   1);  //  40     5
 
-		EEPROM_ReadBuffer(Base + 0x20, &pInfo->SquelchOpenNoiseThresh,   1);  //  65    90
-		EEPROM_ReadBuffer(Base + 0x30, &pInfo->SquelchCloseNoiseThresh,  1);  //  70   100
+		// one byte every 0x10 from Base                                      // VHF   UHF
+		const uint8_t *pSquelch = GetCalibration(gSquelchCache, Base, 0x10, 6);
+		pInfo->SquelchOpenRSSIThresh    = pSquelch[0];                        //  50    10
+		pInfo->SquelchCloseRSSIThresh   = pSquelch[1];                        //  40     5
+
+		pInfo->SquelchOpenNoiseThresh   = pSquelch[2];                        //  65    90
+		pInfo->SquelchCloseNoiseThresh  = pSquelch[3];                        //  70   100
 
-		EEPROM_ReadBuffer(Base + 0x40, &pInfo->SquelchCloseGlitchThresh, 1);  //  90    90
-		EEPROM_ReadBuffer(Base + 0x50, &pInfo->SquelchOpenGlitchThresh,  1);  // 100   100
+		pInfo->SquelchCloseGlitchThresh = pSquelch[4];                        //  90    90
+		pInfo->SquelchOpenGlitchThresh  = pSquelch[5];                        // 100   100
 
 
 		uint16_t noise_open   = pInfo->SquelchOpenNoiseThresh;
@@ -456,7 +549,7 @@ void RADIO_ConfigureSquelchAndOutputPower(VFO_Info_t *pInfo)
 	Band = FREQUENCY_GetBand(pInfo->pTX->Frequency);
 
 	uint8_t Txp[3];
-	EEPROM_ReadBuffer(0x1ED0 + (Band * 16) + (pInfo->OUTPUT_POWER * 3), Txp, 3);
+	memcpy(Txp, GetCalibration(gTxpCache, 0x1ED0 + (Band * 16) + (pInfo->OUTPUT_POWER * 3), 1, 3), 3);
 
 #ifdef ENABLE_REDUCE_LOW_MID_TX_POWER
 	// make low and mid even lower
@@ -482,6 +575,8 @@ void RADIO_ConfigureSquelchAndOutputPower(VFO_Info_t *pInfo)
 		pInfo->pTX->Frequency);
 
 	// *******************************
+
+	PrepareTxImage(pInfo);
 }
 
 void RADIO_ApplyOffset(VFO_Info_t *pInfo)
@@ -527,6 +622,7 @@ void RADIO_SetupRegisters(bool switchToForeground)
 {
 	BK4819_FilterBandwidth_t Bandwidth = gRxVfo->CHANNEL_BANDWIDTH;
 
+	AUDIO_StopTone();
 	AUDIO_AudioPathOff();
 
 	gEnableSpeaker = false;
@@ -755,7 +851,10 @@ void RADIO_SetupRegisters(bool switchToForeground)
 
 void RADIO_SetTxParameters(void)
 {
-	BK4819_FilterBandwidth_t Bandwidth = gCurrentVfo->CHANNEL_BANDWIDTH;
+#ifdef ENABLE_PROFILING
+	const uint32_t start_us = PROFILE_GetTimeUs();
+#endif
+	const RADIO_TxImage_t *pImage = &gCurrentVfo->TxImage;
 
 	AUDIO_AudioPathOff();
 
@@ -763,23 +862,12 @@ void RADIO_SetTxParameters(void)
 
 	BK4819_ToggleGpioOut(BK4819_GPIO0_PIN28_RX_ENABLE, false);
 
-	switch (Bandwidth)
-	{
-		default:
-			Bandwidth = BK4819_FILTER_BW_WIDE;
-			[[fallthrough]];
-		case BK4819_FILTER_BW_WIDE:
-		case BK4819_FILTER_BW_NARROW:
-			#ifdef ENABLE_AM_FIX
-//				BK4819_SetFilterBandwidth(Bandwidth, gCurrentVfo->Modulation == MODULATION_AM && gSetting_AM_fix);
-				BK4819_SetFilterBandwidth(Bandwidth, true);
-			#else
-				BK4819_SetFilterBandwidth(Bandwidth, false);
-			#endif
-			break;
-	}
+	// only when something changed the VFO without reconfiguring it
+	if (!IsTxImageCurrent(gCurrentVfo))
+		PrepareTxImage(gCurrentVfo);
 
-	BK4819_SetFrequency(gCurrentVfo->pTX->Frequency);
+	// filter, frequency and CTCSS/DCS, all in place before the TX is on
+	BK4819_WriteTxImage(&pImage->Regs);
 
 	// TX compressor
 	BK4819_SetCompander((gRxVfo->Modulation == MODULATION_FM && (gRxVfo->Compander == 1 || gRxVfo->Compander >= 3)) ? gRxVfo->Compander : 0);
@@ -788,32 +876,17 @@ void RADIO_SetTxParameters(void)
 
 	SYSTEM_DelayMs(10);
 
-	BK4819_PickRXFilterPathBasedOnFrequency(gCurrentVfo->pTX->Frequency);
+	BK4819_PickRXFilterPathBasedOnFrequency(pImage->Regs.Frequency);
 
 	BK4819_ToggleGpioOut(BK4819_GPIO1_PIN29_PA_ENABLE, true);
 
 	SYSTEM_DelayMs(5);
 
-	BK4819_SetupPowerAmplifier(gCurrentVfo->TXP_CalculatedSetting, gCurrentVfo->pTX->Frequency);
-
-	SYSTEM_DelayMs(10);
-
-	switch (gCurrentVfo->pTX->CodeType)
-	{
-		default:
-		case CODE_TYPE_OFF:
-			BK4819_ExitSubAu();
-			break;
-
-		case CODE_TYPE_CONTINUOUS_TONE:
-			BK4819_SetCTCSSFrequency(CTCSS_Options[gCurrentVfo->pTX->Code]);
-			break;
+	BK4819_WriteRegister(BK4819_REG_36, pImage->Regs.Reg36);   // PA bias, the carrier is up
 
-		case CODE_TYPE_DIGITAL:
-		case CODE_TYPE_REVERSE_DIGITAL:
-			BK4819_SetCDCSSCodeWord(DCS_GetGolayCodeWord(gCurrentVfo->pTX->CodeType, gCurrentVfo->pTX->Code));
-			break;
-	}
+#ifdef ENABLE_PROFILING
+	gProfileCounters[PROFILE_TX_KEY_UP_US] = PROFILE_GetTimeUs() - start_us;
+#endif
 }
 
 void RADIO_SetModulation(ModulationMode_t modulation)
@@ -1004,7 +1077,15 @@ void RADIO_PrepareTX(void)
 #endif
 }
 
-void RADIO_SendCssTail(void)
+// held for 200ms, from the timeslice
+static const AUDIO_ToneStep_t CssTailHold[] =
+{
+	{ AUDIO_TONE_WAIT, 20, 0 },
+	{ AUDIO_TONE_END,   0, 0 }
+};
+
+// pDone runs once the tail tone has been held long enough
+void RADIO_SendCssTail(void (*pDone)(void))
 {
 	switch (gCurrentVfo->pTX->CodeType) {
 	case CODE_TYPE_DIGITAL:
@@ -1016,27 +1097,57 @@ void RADIO_SendCssTail(void)
 		break;
 	}
 
-	SYSTEM_DelayMs(200);
+	AUDIO_PlayTones(CssTailHold, 0, pDone);
 }
 
-void RADIO_SendEndOfTransmission(void)
+static void SetupRegistersRx(void)
 {
-	BK4819_PlayRoger();
-	DTMF_SendEndOfTransmission();
+	RADIO_SetupRegisters(false);
+}
 
+static void SetupRegistersForeground(void)
+{
+	RADIO_SetupRegisters(true);
+}
+
+static void SendEndOfTransmissionTail(void)
+{
 	// send the CTCSS/DCS tail tone - allows the receivers to mute the usual FM squelch tail/crash
 	if(gEeprom.TAIL_TONE_ELIMINATION)
-		RADIO_SendCssTail();
-	RADIO_SetupRegisters(false);
+		RADIO_SendCssTail(SetupRegistersRx);
+	else
+		SetupRegistersRx();
 }
 
-void RADIO_PrepareCssTX(void)
+static void SendEndOfTransmissionId(void)
 {
-	RADIO_PrepareTX();
+	DTMF_SendEndOfTransmission(SendEndOfTransmissionTail);
+}
 
-	SYSTEM_DelayMs(200);
+// the roger and the PTT ID play from the timeslice, the rest follows once they're done
+void RADIO_SendEndOfTransmission(void)
+{
+	if (!AUDIO_PlayRoger(SendEndOfTransmissionId))
+		SendEndOfTransmissionId();
+}
 
+static void SendCssReplyTail(void)
+{
 	if(gEeprom.TAIL_TONE_ELIMINATION)
-		RADIO_SendCssTail();
-	RADIO_SetupRegisters(true);
+		RADIO_SendCssTail(SetupRegistersForeground);
+	else
+		SetupRegistersForeground();
+}
+
+static void HoldCssReply(void)
+{
+	AUDIO_PlayTones(CssTailHold, 0, SendCssReplyTail);
+}
+
+void RADIO_PrepareCssTX(void)
+{
+	RADIO_PrepareTX();
+
+	// the reply goes out from the timeslice, keep the carrier up 200ms after it
+	AUDIO_WhenToneDone(HoldCssReply);
 }
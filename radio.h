@@ -21,6 +21,7 @@
 #include <stdint.h>
 
 #include "dcs.h"
+#include "driver/bk4819.h"
 #include "frequencies.h"
 
 enum {
@@ -78,6 +79,15 @@ typedef struct
 	uint8_t        Padding[2];
 } FREQ_Config_t;
 
+// the TX registers of a VFO and the settings they were built from
+typedef struct {
+	BK4819_TxImage_t Regs;
+	uint8_t          Bias;
+	uint8_t          Bandwidth;
+	uint8_t          CodeType;
+	uint8_t          Code;
+} RADIO_TxImage_t;
+
 typedef struct VFO_Info_t
 {
 	FREQ_Config_t  freq_config_RX;
@@ -130,6 +140,8 @@ typedef struct VFO_Info_t
 	uint8_t        Compander;
 
 	char           Name[16];
+
+	RADIO_TxImage_t TxImage;   // kept ready for key up
 } VFO_Info_t;
 
 // Settings of the main VFO that is selected by the user
@@ -146,6 +158,12 @@ extern VFO_Info_t    *gCurrentVfo;
 
 extern DCS_CodeType_t gCurrentCodeType;
 
+#ifdef ENABLE_CSS_DECODE
+// the tone/code heard on a carrier squelch reception, CODE_TYPE_OFF until one is decoded
+extern DCS_CodeType_t gRxCssDecodeType;
+extern uint8_t        gRxCssDecodeCode;
+#endif
+
 extern VfoState_t     VfoState[2];
 
 bool     RADIO_CheckValidChannel(uint16_t channel, bool checkScanList, uint8_t scanList);
@@ -153,6 +171,7 @@ uint8_t  RADIO_FindNextChannel(uint8_t ChNum, int8_t Direction, bool bCheckScanL
 void     RADIO_InitInfo(VFO_Info_t *pInfo, const uint8_t ChannelSave, const uint32_t Frequency);
 void     RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure);
 void     RADIO_ConfigureSquelchAndOutputPower(VFO_Info_t *pInfo);
+void     RADIO_InvalidateCalibrationCache(void);
 void     RADIO_ApplyOffset(VFO_Info_t *pInfo);
 void     RADIO_SelectVfos(void);
 void     RADIO_SetupRegisters(bool switchToForeground);
@@ -164,7 +183,7 @@ void 	 RADIO_SetupAGC(bool listeningAM, bool disable);
 void     RADIO_SetModulation(ModulationMode_t modulation);
 void     RADIO_SetVfoState(VfoState_t State);
 void     RADIO_PrepareTX(void);
-void     RADIO_SendCssTail(void);
+void     RADIO_SendCssTail(void (*pDone)(void));
 void     RADIO_PrepareCssTX(void);
 void     RADIO_SendEndOfTransmission(void);
 
@@ -15,6 +15,9 @@
  */
 
 #include "app/chFrScanner.h"
+#ifdef ENABLE_CHANNEL_STATS
+	#include "app/chstats.h"
+#endif
 #ifdef ENABLE_FMRADIO
 	#include "app/fm.h"
 #endif
@@ -22,12 +25,21 @@
 #include "audio.h"
 #include "functions.h"
 #include "helper/battery.h"
+#ifdef ENABLE_PROFILING
+	#include "helper/profile.h"
+#endif
+#include "helper/rssi.h"
+#ifdef ENABLE_RSSI_TRACE
+	#include "helper/rssi_trace.h"
+#endif
+#include "helper/task.h"
 #include "misc.h"
 #include "settings.h"
 
 #include "driver/backlight.h"
 #include "bsp/dp32g030/gpio.h"
 #include "driver/gpio.h"
+#include "driver/systick.h"
 
 #define DECREMENT(cnt) \
 	do {               \
@@ -46,8 +58,7 @@ static volatile uint32_t gGlobalSysTickCounter;
 
 void SystickHandler(void);
 
-// we come here every 10ms
-void SystickHandler(void)
+static void Tick_10ms(void)
 {
 	gGlobalSysTickCounter++;
 	
@@ -109,4 +120,32 @@ void SystickHandler(void)
 #endif
 
 	DECREMENT(boot_counter_10ms);
+
+	RSSI_Tick();
+
+	BATTERY_Tick();
+
+	TASK_Tick();
+
+#ifdef ENABLE_RSSI_TRACE
+	RSSI_TRACE_Tick();
+#endif
+
+#ifdef ENABLE_CHANNEL_STATS
+	CHSTATS_Tick();
+#endif
+}
+
+// we come here every 10ms, or every few 10ms while the main loop idles
+// with a coarser systick period
+void SystickHandler(void)
+{
+	const uint8_t elapsed_10ms = SYSTICK_GetElapsed_10ms();
+
+	for (uint8_t i = elapsed_10ms; i > 0; i--)
+		Tick_10ms();
+
+#ifdef ENABLE_PROFILING
+	PROFILE_Tick(elapsed_10ms);
+#endif
 }
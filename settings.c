@@ -23,6 +23,9 @@
 #include "driver/bk1080.h"
 #include "driver/bk4819.h"
 #include "driver/eeprom.h"
+#ifdef ENABLE_PROFILING
+	#include "helper/profile.h"
+#endif
 #include "misc.h"
 #include "settings.h"
 #include "ui/menu.h"
@@ -38,11 +41,18 @@ static const uint32_t gDefaultFrequencyTable[] =
 
 EEPROM_Config_t gEeprom = { 0 };
 
+#define SETTINGS_BLOCK(addr) (Block + (addr) - 0x0E70)
+
 void SETTINGS_InitEEPROM(void)
 {
-	uint8_t Data[16] = {0};
+	// 0E70..0F4F in one sequential read instead of one transaction per setting group
+	uint8_t Block[0x0F50 - 0x0E70];
+	uint8_t *Data;
+
+	EEPROM_ReadBuffer(0x0E70, Block, sizeof(Block));
+
 	// 0E70..0E77
-	EEPROM_ReadBuffer(0x0E70, Data, 8);
+	Data = SETTINGS_BLOCK(0x0E70);
 	gEeprom.CHAN_1_CALL          = IS_MR_CHANNEL(Data[0]) ? Data[0] : MR_CHANNEL_FIRST;
 	gEeprom.SQUELCH_LEVEL        = (Data[1] < 10) ? Data[1] : 1;
 	gEeprom.TX_TIMEOUT_TIMER     = (Data[2] < 11) ? Data[2] : 1;
@@ -57,7 +67,7 @@ void SETTINGS_InitEEPROM(void)
 	gEeprom.MIC_SENSITIVITY      = (Data[7] <  5) ? Data[7] : 4;
 
 	// 0E78..0E7F
-	EEPROM_ReadBuffer(0x0E78, Data, 8);
+	Data = SETTINGS_BLOCK(0x0E78);
 	gEeprom.BACKLIGHT_MAX 		  = (Data[0] & 0xF) <= 10 ? (Data[0] & 0xF) : 10;
 	gEeprom.BACKLIGHT_MIN 		  = (Data[0] >> 4) < gEeprom.BACKLIGHT_MAX ? (Data[0] >> 4) : 0;
 #ifdef ENABLE_BLMIN_TMP_OFF
@@ -72,7 +82,7 @@ void SETTINGS_InitEEPROM(void)
 	gEeprom.VFO_OPEN              = (Data[7] < 2) ? Data[7] : true;
 
 	// 0E80..0E87
-	EEPROM_ReadBuffer(0x0E80, Data, 8);
+	Data = SETTINGS_BLOCK(0x0E80);
 	gEeprom.ScreenChannel[0]   = IS_VALID_CHANNEL(Data[0]) ? Data[0] : (FREQ_CHANNEL_FIRST + BAND6_400MHz);
 	gEeprom.ScreenChannel[1]   = IS_VALID_CHANNEL(Data[3]) ? Data[3] : (FREQ_CHANNEL_FIRST + BAND6_400MHz);
 	gEeprom.MrChannel[0]       = IS_MR_CHANNEL(Data[1])    ? Data[1] : MR_CHANNEL_FIRST;
@@ -94,7 +104,7 @@ void SETTINGS_InitEEPROM(void)
 			uint8_t  band:2;
 			//uint8_t  space:2;
 		} __attribute__((packed)) fmCfg;
-		EEPROM_ReadBuffer(0x0E88, &fmCfg, 4);
+		memcpy(&fmCfg, SETTINGS_BLOCK(0x0E88), 4);
 
 		gEeprom.FM_Band = fmCfg.band;
 		//gEeprom.FM_Space = fmCfg.space;
@@ -112,7 +122,7 @@ void SETTINGS_InitEEPROM(void)
 #endif
 
 	// 0E90..0E97
-	EEPROM_ReadBuffer(0x0E90, Data, 8);
+	Data = SETTINGS_BLOCK(0x0E90);
 	gEeprom.BEEP_CONTROL                 = Data[0] & 1;
 	gEeprom.KEY_M_LONG_PRESS_ACTION      = ((Data[0] >> 1) < ACTION_OPT_LEN) ? (Data[0] >> 1) : ACTION_OPT_NONE;
 	gEeprom.KEY_1_SHORT_PRESS_ACTION     = (Data[1] < ACTION_OPT_LEN) ? Data[1] : ACTION_OPT_MONITOR;
@@ -124,11 +134,11 @@ void SETTINGS_InitEEPROM(void)
 	gEeprom.POWER_ON_DISPLAY_MODE        = (Data[7] < 4)              ? Data[7] : POWER_ON_DISPLAY_MODE_VOLTAGE;
 
 	// 0E98..0E9F
-	EEPROM_ReadBuffer(0x0E98, Data, 8);
+	Data = SETTINGS_BLOCK(0x0E98);
 	memcpy(&gEeprom.POWER_ON_PASSWORD, Data, 4);
 
 	// 0EA0..0EA7
-	EEPROM_ReadBuffer(0x0EA0, Data, 8);
+	Data = SETTINGS_BLOCK(0x0EA0);
 	#ifdef ENABLE_VOICE
 	gEeprom.VOICE_PROMPT = (Data[0] < 3) ? Data[0] : VOICE_PROMPT_ENGLISH;
 	#endif
@@ -144,7 +154,7 @@ void SETTINGS_InitEEPROM(void)
 	#endif
 
 	// 0EA8..0EAF
-	EEPROM_ReadBuffer(0x0EA8, Data, 8);
+	Data = SETTINGS_BLOCK(0x0EA8);
 	#ifdef ENABLE_ALARM
 		gEeprom.ALARM_MODE                 = (Data[0] <  2) ? Data[0] : true;
 	#endif
@@ -154,7 +164,7 @@ void SETTINGS_InitEEPROM(void)
 	gEeprom.BATTERY_TYPE                   = (Data[4] < BATTERY_TYPE_UNKNOWN) ? Data[4] : BATTERY_TYPE_1600_MAH;
 
 	// 0ED0..0ED7
-	EEPROM_ReadBuffer(0x0ED0, Data, 8);
+	Data = SETTINGS_BLOCK(0x0ED0);
 	gEeprom.DTMF_SIDE_TONE               = (Data[0] <   2) ? Data[0] : true;
 
 #ifdef ENABLE_DTMF_CALLING
@@ -168,7 +178,7 @@ void SETTINGS_InitEEPROM(void)
 	gEeprom.DTMF_HASH_CODE_PERSIST_TIME  = (Data[7] < 101) ? Data[7] * 10 : 100;
 
 	// 0ED8..0EDF
-	EEPROM_ReadBuffer(0x0ED8, Data, 8);
+	Data = SETTINGS_BLOCK(0x0ED8);
 	gEeprom.DTMF_CODE_PERSIST_TIME  = (Data[0] < 101) ? Data[0] * 10 : 100;
 	gEeprom.DTMF_CODE_INTERVAL_TIME = (Data[1] < 101) ? Data[1] * 10 : 100;
 #ifdef ENABLE_DTMF_CALLING
@@ -176,7 +186,7 @@ void SETTINGS_InitEEPROM(void)
 
 	// 0EE0..0EE7
 
-	EEPROM_ReadBuffer(0x0EE0, Data, sizeof(gEeprom.ANI_DTMF_ID));
+	Data = SETTINGS_BLOCK(0x0EE0);
 	if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.ANI_DTMF_ID))) {
 		memcpy(gEeprom.ANI_DTMF_ID, Data, sizeof(gEeprom.ANI_DTMF_ID));
 	} else {
@@ -185,7 +195,7 @@ void SETTINGS_InitEEPROM(void)
 
 
 	// 0EE8..0EEF
-	EEPROM_ReadBuffer(0x0EE8, Data, sizeof(gEeprom.KILL_CODE));
+	Data = SETTINGS_BLOCK(0x0EE8);
 	if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.KILL_CODE))) {
 		memcpy(gEeprom.KILL_CODE, Data, sizeof(gEeprom.KILL_CODE));
 	} else {
@@ -193,7 +203,7 @@ void SETTINGS_InitEEPROM(void)
 	}
 
 	// 0EF0..0EF7
-	EEPROM_ReadBuffer(0x0EF0, Data, sizeof(gEeprom.REVIVE_CODE));
+	Data = SETTINGS_BLOCK(0x0EF0);
 	if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.REVIVE_CODE))) {
 		memcpy(gEeprom.REVIVE_CODE, Data, sizeof(gEeprom.REVIVE_CODE));
 	} else {
@@ -202,7 +212,7 @@ void SETTINGS_InitEEPROM(void)
 #endif
 
 	// 0EF8..0F07
-	EEPROM_ReadBuffer(0x0EF8, Data, sizeof(gEeprom.DTMF_UP_CODE));
+	Data = SETTINGS_BLOCK(0x0EF8);
 	if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.DTMF_UP_CODE))) {
 		memcpy(gEeprom.DTMF_UP_CODE, Data, sizeof(gEeprom.DTMF_UP_CODE));
 	} else {
@@ -210,7 +220,7 @@ void SETTINGS_InitEEPROM(void)
 	}
 
 	// 0F08..0F17
-	EEPROM_ReadBuffer(0x0F08, Data, sizeof(gEeprom.DTMF_DOWN_CODE));
+	Data = SETTINGS_BLOCK(0x0F08);
 	if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.DTMF_DOWN_CODE))) {
 		memcpy(gEeprom.DTMF_DOWN_CODE, Data, sizeof(gEeprom.DTMF_DOWN_CODE));
 	} else {
@@ -218,7 +228,7 @@ void SETTINGS_InitEEPROM(void)
 	}
 
 	// 0F18..0F1F
-	EEPROM_ReadBuffer(0x0F18, Data, 8);
+	Data = SETTINGS_BLOCK(0x0F18);
 	gEeprom.SCAN_LIST_DEFAULT = (Data[0] < 3) ? Data[0] : 0;  // we now have 'all' channel scan option
 	for (unsigned int i = 0; i < 2; i++)
 	{
@@ -229,7 +239,7 @@ void SETTINGS_InitEEPROM(void)
 	}
 
 	// 0F40..0F47
-	EEPROM_ReadBuffer(0x0F40, Data, 8);
+	Data = SETTINGS_BLOCK(0x0F40);
 	gSetting_F_LOCK            = (Data[0] < F_LOCK_LEN) ? Data[0] : F_LOCK_DEF;
 	gSetting_350TX             = (Data[1] < 2) ? Data[1] : false;  // was true
 #ifdef ENABLE_DTMF_CALLING
@@ -267,7 +277,7 @@ void SETTINGS_InitEEPROM(void)
 	}
 
 	// 0F30..0F3F
-	EEPROM_ReadBuffer(0x0F30, gCustomAesKey, sizeof(gCustomAesKey));
+	memcpy(gCustomAesKey, SETTINGS_BLOCK(0x0F30), sizeof(gCustomAesKey));
 	bHasCustomAesKey = false;
 	for (unsigned int i = 0; i < ARRAY_SIZE(gCustomAesKey); i++)
 	{
@@ -279,10 +289,9 @@ void SETTINGS_InitEEPROM(void)
 	}
 }
 
-void SETTINGS_LoadCalibration(void)
+// only used by the S-meter display, loaded after boot
+void SETTINGS_LoadRssiCalibration(void)
 {
-//	uint8_t Mic;
-
 	EEPROM_ReadBuffer(0x1EC0, gEEPROM_RSSI_CALIB[3], 8);
 	memcpy(gEEPROM_RSSI_CALIB[4], gEEPROM_RSSI_CALIB[3], 8);
 	memcpy(gEEPROM_RSSI_CALIB[5], gEEPROM_RSSI_CALIB[3], 8);
@@ -291,6 +300,11 @@ void SETTINGS_LoadCalibration(void)
 	EEPROM_ReadBuffer(0x1EC8, gEEPROM_RSSI_CALIB[0], 8);
 	memcpy(gEEPROM_RSSI_CALIB[1], gEEPROM_RSSI_CALIB[0], 8);
 	memcpy(gEEPROM_RSSI_CALIB[2], gEEPROM_RSSI_CALIB[0], 8);
+}
+
+void SETTINGS_LoadCalibration(void)
+{
+//	uint8_t Mic;
 
 	EEPROM_ReadBuffer(0x1F40, gBatteryCalibration, 12);
 	if (gBatteryCalibration[0] >= 5000)
@@ -347,6 +361,24 @@ uint32_t SETTINGS_FetchChannelFrequency(const int channel)
 	return info.frequency;
 }
 
+// decoded names of the most recently displayed channels, most recent first,
+// saves the I2C read on every redraw
+#define CHANNEL_NAME_CACHE_SIZE 8
+
+typedef struct {
+	uint8_t key;                 // channel + 1, 0 = unused
+	char    name[11];
+} ChannelNameCache_t;
+
+static ChannelNameCache_t gChannelNameCache[CHANNEL_NAME_CACHE_SIZE];
+
+void SETTINGS_InvalidateChannelNameCache(const int channel)
+{
+	for (unsigned int i = 0; i < CHANNEL_NAME_CACHE_SIZE; i++)
+		if (channel < 0 || gChannelNameCache[i].key == channel + 1)
+			gChannelNameCache[i].key = 0;
+}
+
 void SETTINGS_FetchChannelName(char *s, const int channel)
 {
 	if (s == NULL)
@@ -360,17 +392,54 @@ void SETTINGS_FetchChannelName(char *s, const int channel)
 	if (!RADIO_CheckValidChannel(channel, false, 0))
 		return;
 
-	EEPROM_ReadBuffer(0x0F50 + (channel * 16), s, 10);
+	// an unused slot is taken before the least recently used entry (last slot)
+	unsigned int slot   = CHANNEL_NAME_CACHE_SIZE;
+	unsigned int victim = CHANNEL_NAME_CACHE_SIZE - 1;
+	for (unsigned int i = 0; i < CHANNEL_NAME_CACHE_SIZE; i++) {
+		if (gChannelNameCache[i].key == channel + 1) {
+			slot = i;
+			break;
+		}
+
+		if (gChannelNameCache[i].key == 0 && victim == CHANNEL_NAME_CACHE_SIZE - 1)
+			victim = i;
+	}
+
+	if (slot < CHANNEL_NAME_CACHE_SIZE) {
+#ifdef ENABLE_PROFILING
+		gProfileCounters[PROFILE_NAME_CACHE_HITS]++;
+#endif
+	}
+	else {
+		slot = victim;
+#ifdef ENABLE_PROFILING
+		gProfileCounters[PROFILE_NAME_CACHE_MISSES]++;
+#endif
+		char *name = gChannelNameCache[slot].name;
+
+		EEPROM_ReadBuffer(0x0F50 + (channel * 16), name, 10);
+
+		int i;
+		for (i = 0; i < 10; i++)
+			if (name[i] < 32 || name[i] > 127)
+				break;                // invalid char
+
+		name[i--] = 0;                // null term
 
-	int i;
-	for (i = 0; i < 10; i++)
-		if (s[i] < 32 || s[i] > 127)
-			break;                // invalid char
+		while (i >= 0 && name[i] == 32)  // trim trailing spaces
+			name[i--] = 0;               // null term
 
-	s[i--] = 0;                   // null term
+		gChannelNameCache[slot].key = channel + 1;
+	}
+
+	// move the entry to the front
+	if (slot > 0) {
+		const ChannelNameCache_t entry = gChannelNameCache[slot];
+		memmove(&gChannelNameCache[1], &gChannelNameCache[0], slot * sizeof(ChannelNameCache_t));
+		gChannelNameCache[0] = entry;
+	}
 
-	while (i >= 0 && s[i] == 32)  // trim trailing spaces
-		s[i--] = 0;               // null term
+	strcpy(s, gChannelNameCache[0].name);
 }
 
 void SETTINGS_FactoryReset(bool bIsAll)
@@ -402,6 +471,8 @@ void SETTINGS_FactoryReset(bool bIsAll)
 		}
 	}
 
+	SETTINGS_InvalidateChannelNameCache(-1);
+
 	if (bIsAll)
 	{
 		RADIO_InitInfo(gRxVfo, FREQ_CHANNEL_FIRST + BAND6_400MHz, 43350000);
@@ -669,6 +740,7 @@ void SETTINGS_SaveChannelName(uint8_t channel, const char * name)
 	memcpy(buf, name, MIN(strlen(name), 10u));
 	EEPROM_WriteBuffer(0x0F50 + offset, buf);
 	EEPROM_WriteBuffer(0x0F58 + offset, buf + 8);
+	SETTINGS_InvalidateChannelNameCache(channel);
 }
 
 void SETTINGS_UpdateChannel(uint8_t channel, const VFO_Info_t *pVFO, bool keep)
@@ -91,6 +91,7 @@ enum ACTION_OPT_t {
 	ACTION_OPT_SWITCH_DEMODUL,
 	ACTION_OPT_BLMIN_TMP_OFF, //BackLight Minimum Temporay OFF
 	ACTION_OPT_SPECTRUM,
+	ACTION_OPT_CHSTATS,
 	ACTION_OPT_LEN
 };
 
@@ -257,9 +258,11 @@ typedef struct {
 extern EEPROM_Config_t gEeprom;
 
 void     SETTINGS_InitEEPROM(void);
+void     SETTINGS_LoadRssiCalibration(void);
 void     SETTINGS_LoadCalibration(void);
 uint32_t SETTINGS_FetchChannelFrequency(const int channel);
 void     SETTINGS_FetchChannelName(char *s, const int channel);
+void     SETTINGS_InvalidateChannelNameCache(const int channel);
 void     SETTINGS_FactoryReset(bool bIsAll);
 #ifdef ENABLE_FMRADIO
 	void SETTINGS_SaveFM(void);
@@ -0,0 +1,86 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <string.h>
+
+#include "app/chstats.h"
+#include "driver/st7565.h"
+#include "helper/format.h"
+#include "misc.h"
+#include "settings.h"
+#include "ui/chstats.h"
+#include "ui/helper.h"
+#include "ui/main.h"
+
+#define CHSTATS_ROWS 6
+
+void UI_DisplayChannelStats(void)
+{
+	char String[22];
+
+	UI_DisplayClear();
+
+	const uint8_t First = (gChannelStatsCursor < CHSTATS_ROWS) ? 0 : gChannelStatsCursor - (CHSTATS_ROWS - 1);
+
+	// channel, squelch openings, seconds open
+	for (uint8_t Row = 0; Row < CHSTATS_ROWS; Row++) {
+		const uint8_t Index = First + Row;
+		if (Index >= ARRAY_SIZE(gChannelStatsOrder))
+			break;
+
+		const uint8_t            Channel = gChannelStatsOrder[Index];
+		const CHSTATS_Channel_t *pStats  = &gChannelStats[Channel];
+
+		if (pStats->Hits == 0) {
+			if (Row == 0)
+				UI_PrintString("NO ACTIVITY", 0, 127, 2, 8);
+			break;
+		}
+
+		char *p = String;
+		*p++ = (Index == gChannelStatsCursor) ? '>' : ' ';
+		p    = FORMAT_Unsigned(p, Channel + 1, 3, '0');
+		*p++ = ' ';
+		p    = FORMAT_Unsigned(p, pStats->Hits, 5, ' ');
+		*p++ = ' ';
+		p    = FORMAT_Decimal(p, pStats->OpenTime_10ms, 2, 0, 6, ' ');
+		*p++ = 's';
+		*p   = 0;
+		UI_PrintStringSmallNormal(String, 0, 0, Row);
+	}
+
+	// the selected channel's name, peak level and when it was last heard
+	const uint8_t            Channel = gChannelStatsOrder[gChannelStatsCursor];
+	const CHSTATS_Channel_t *pStats  = &gChannelStats[Channel];
+
+	if (pStats->Hits > 0) {
+		SETTINGS_FetchChannelName(String, Channel);
+		UI_PrintStringSmallNormal(String[0] ? String : "--", 0, 0, 6);
+
+		const int16_t Dbm = pStats->PeakRssi - 160 + dBmCorrTable[gMR_ChannelAttributes[Channel].band];
+		FORMAT_Dbm(String, Dbm);
+		UI_PrintStringSmallNormal(String, 76, 0, 6);
+
+		if (pStats->LastHeard_10ms != 0) {
+			char *p = FORMAT_Decimal(String, CHSTATS_GetTick() - pStats->LastHeard_10ms, 2, 0, 0, ' ');
+			strcpy(p, "s AGO");
+			UI_PrintStringSmallNormal(String, 0, 0, 7);
+		}
+	}
+
+	ST7565_BlitFullScreen();
+}
@@ -65,17 +65,67 @@ void UI_GenerateChannelStringEx(char *pString, const bool bShowPrefix, const uin
 	}
 }
 
-void UI_PrintStringBuffer(const char *pString, uint8_t * buffer, uint32_t char_width, const uint8_t *font)
+// small fonts selected by table instead of per call #ifdefs
+typedef struct {
+	const uint8_t *glyphs;
+	uint8_t        width;
+} SmallFont_t;
+
+enum {
+	FONT_SMALL_NORMAL = 0,
+	FONT_SMALL_BOLD
+};
+
+static const SmallFont_t SmallFonts[] = {
+	[FONT_SMALL_NORMAL] = {(const uint8_t *)gFontSmall,     ARRAY_SIZE(gFontSmall[0])},
+#ifdef ENABLE_SMALL_BOLD
+	[FONT_SMALL_BOLD]   = {(const uint8_t *)gFontSmallBold, ARRAY_SIZE(gFontSmallBold[0])},
+#else
+	[FONT_SMALL_BOLD]   = {(const uint8_t *)gFontSmall,     ARRAY_SIZE(gFontSmall[0])},
+#endif
+};
+
+// copy one glyph into the frame buffer
+// the M0 can't do unaligned word accesses, so 32-bit stores are only used
+// when source and destination share the same alignment, the fixed size
+// memcpy on word aligned pointers compiles to a single load and store
+// without punning the byte buffers
+static inline void BlitGlyph(uint8_t *pDst, const uint8_t *pSrc, unsigned int width)
 {
-	const size_t Length = strlen(pString);
-	const unsigned int char_spacing = char_width + 1;
-	for (size_t i = 0; i < Length; i++) {
-		const unsigned int index = pString[i] - ' ' - 1;
-		if (pString[i] > ' ' && pString[i] < 127) {
-			const uint32_t offset = i * char_spacing + 1;
-			memcpy(buffer + offset, font + index * char_width, char_width);
+	if ((((uintptr_t)pDst ^ (uintptr_t)pSrc) & 3u) == 0) {
+		while (width > 0 && ((uintptr_t)pDst & 3u) != 0) {
+			*pDst++ = *pSrc++;
+			width--;
 		}
+		for (; width >= 4; width -= 4, pDst += 4, pSrc += 4)
+			memcpy(__builtin_assume_aligned(pDst, 4), __builtin_assume_aligned(pSrc, 4), sizeof(uint32_t));
+	}
+
+	while (width--)
+		*pDst++ = *pSrc++;
+}
+
+static void PrintStringBuffer(const char *pString, size_t Length, uint8_t *buffer, const SmallFont_t *font)
+{
+	const unsigned int char_width = font->width;
+
+	buffer++;
+	for (size_t i = 0; i < Length; i++, buffer += char_width + 1) {
+		const char c = pString[i];
+		if (c > ' ' && c < 127)
+			BlitGlyph(buffer, font->glyphs + (c - ' ' - 1) * char_width, char_width);
+	}
+}
+
+static void PrintStringSmall(const char *pString, uint8_t Start, uint8_t End, uint8_t Line, const SmallFont_t *font)
+{
+	const size_t Length = strlen(pString);
+
+	if (End > Start) {
+		Start += (((End - Start) - Length * (font->width + 1)) + 1) / 2;
 	}
+
+	PrintStringBuffer(pString, Length, gFrameBuffer[Line] + Start, font);
 }
 
 void UI_PrintString(const char *pString, uint8_t Start, uint8_t End, uint8_t Line, uint8_t Width)
@@ -86,63 +136,38 @@ void UI_PrintString(const char *pString, uint8_t Start, uint8_t End, uint8_t Lin
 	if (End > Start)
 		Start += (((End - Start) - (Length * Width)) + 1) / 2;
 
-	for (i = 0; i < Length; i++)
+	uint8_t *pFb0 = gFrameBuffer[Line + 0] + Start;
+	uint8_t *pFb1 = gFrameBuffer[Line + 1] + Start;
+
+	for (i = 0; i < Length; i++, pFb0 += Width, pFb1 += Width)
 	{
-		const unsigned int ofs   = (unsigned int)Start + (i * Width);
 		if (pString[i] > ' ' && pString[i] < 127)
 		{
 			const unsigned int index = pString[i] - ' ' - 1;
-			memcpy(gFrameBuffer[Line + 0] + ofs, &gFontBig[index][0], 7);
-			memcpy(gFrameBuffer[Line + 1] + ofs, &gFontBig[index][7], 7);
+			BlitGlyph(pFb0, &gFontBig[index][0], 7);
+			BlitGlyph(pFb1, &gFontBig[index][7], 7);
 		}
 	}
 }
 
-void UI_PrintStringSmall(const char *pString, uint8_t Start, uint8_t End, uint8_t Line, uint8_t char_width, const uint8_t *font)
-{
-	const size_t Length = strlen(pString);
-	const unsigned int char_spacing = char_width + 1;
-
-	if (End > Start) {
-		Start += (((End - Start) - Length * char_spacing) + 1) / 2;
-	}
-
-	UI_PrintStringBuffer(pString, gFrameBuffer[Line] + Start, char_width, font);
-}
-
 void UI_PrintStringSmallNormal(const char *pString, uint8_t Start, uint8_t End, uint8_t Line)
 {
-	UI_PrintStringSmall(pString, Start, End, Line, ARRAY_SIZE(gFontSmall[0]), (const uint8_t *)gFontSmall);
+	PrintStringSmall(pString, Start, End, Line, &SmallFonts[FONT_SMALL_NORMAL]);
 }
 
 void UI_PrintStringSmallBold(const char *pString, uint8_t Start, uint8_t End, uint8_t Line)
 {
-#ifdef ENABLE_SMALL_BOLD
-	const uint8_t *font = (uint8_t *)gFontSmallBold;
-	const uint8_t char_width = ARRAY_SIZE(gFontSmallBold[0]);
-#else
-	const uint8_t *font = (uint8_t *)gFontSmall;
-	const uint8_t char_width = ARRAY_SIZE(gFontSmall[0]);
-#endif
-
-	UI_PrintStringSmall(pString, Start, End, Line, char_width, font);
+	PrintStringSmall(pString, Start, End, Line, &SmallFonts[FONT_SMALL_BOLD]);
 }
 
 void UI_PrintStringSmallBufferNormal(const char *pString, uint8_t * buffer)
 {
-	UI_PrintStringBuffer(pString, buffer, ARRAY_SIZE(gFontSmall[0]), (uint8_t *)gFontSmall);
+	PrintStringBuffer(pString, strlen(pString), buffer, &SmallFonts[FONT_SMALL_NORMAL]);
 }
 
 void UI_PrintStringSmallBufferBold(const char *pString, uint8_t * buffer)
 {
-#ifdef ENABLE_SMALL_BOLD
-	const uint8_t *font = (uint8_t *)gFontSmallBold;
-	const uint8_t char_width = ARRAY_SIZE(gFontSmallBold[0]);
-#else
-	const uint8_t *font = (uint8_t *)gFontSmall;
-	const uint8_t char_width = ARRAY_SIZE(gFontSmall[0]);
-#endif
-	UI_PrintStringBuffer(pString, buffer, char_width, font);
+	PrintStringBuffer(pString, strlen(pString), buffer, &SmallFonts[FONT_SMALL_BOLD]);
 }
 
 void UI_DisplayFrequency(const char *string, uint8_t X, uint8_t Y, bool center)
@@ -160,8 +185,8 @@ void UI_DisplayFrequency(const char *string, uint8_t X, uint8_t Y, bool center)
 		{
 			bCanDisplay = true;
 			if(c>='0' && c<='9' + 1) {
-				memcpy(pFb0 + 2, gFontBigDigits[c-'0'],                  char_width - 3);
-				memcpy(pFb1 + 2, gFontBigDigits[c-'0'] + char_width - 3, char_width - 3);
+				BlitGlyph(pFb0 + 2, gFontBigDigits[c-'0'],                  char_width - 3);
+				BlitGlyph(pFb1 + 2, gFontBigDigits[c-'0'] + char_width - 3, char_width - 3);
 			}
 			else if(c=='.') {
 				*pFb1 = 0x60; pFb0++; pFb1++;
@@ -64,6 +64,8 @@ void UI_DisplayLock(void)
 
 		gNextTimeslice = false;
 
+		AUDIO_ToneTick();
+
 		Key = KEYBOARD_Poll();
 
 		if (gKeyReading0 == Key)
@@ -29,6 +29,9 @@
 #include "external/printf/printf.h"
 #include "functions.h"
 #include "helper/battery.h"
+#include "helper/fixed.h"
+#include "helper/format.h"
+#include "helper/rssi.h"
 #include "misc.h"
 #include "radio.h"
 #include "settings.h"
@@ -198,22 +201,35 @@ void DisplayRSSIBar(const bool now)
 
 	const int16_t s0_dBm   = -gEeprom.S0_LEVEL;                  // S0 .. base level
 	const int16_t rssi_dBm =
-		BK4819_GetRSSI_dBm()
+		(RSSI_GetAverage() / 2) - 160
 #ifdef ENABLE_AM_FIX
 		+ ((gSetting_AM_fix && gRxVfo->Modulation == MODULATION_AM) ? AM_fix_get_gain_diff() : 0)
 #endif
 		+ dBmCorrTable[gRxVfo->Band];
 
-	int s0_9 = gEeprom.S0_LEVEL - gEeprom.S9_LEVEL;
-	const uint8_t s_level = MIN(MAX((int32_t)(rssi_dBm - s0_dBm)*100 / (s0_9*100/9), 0), 9); // S0 - S9
-	uint8_t overS9dBm = MIN(MAX(rssi_dBm + gEeprom.S9_LEVEL, 0), 99);
-	uint8_t overS9Bars = MIN(overS9dBm/10, 4);
+	// redrawn on every RSSI update, the S-unit width only changes with the calibration
+	static FIXED_Divider_t sUnitDiv, nineDiv, tenDiv;
+	FIXED_SetDivisor(&nineDiv, 9);
+	FIXED_SetDivisor(&tenDiv, 10);
+	const int      s0_9   = gEeprom.S0_LEVEL - gEeprom.S9_LEVEL;
+	const uint32_t s_unit = FIXED_Divide((s0_9 < 0 ? -s0_9 : s0_9) * 100, &nineDiv);
+	const int32_t  s_num  = (int32_t)(rssi_dBm - s0_dBm) * 100;
+	uint8_t s_level = 0; // S0 - S9
+	if (s_unit > 0) {
+		// S9 calibrated below S0 counts the other way
+		const int32_t num = (s0_9 < 0) ? -s_num : s_num;
+		FIXED_SetDivisor(&sUnitDiv, s_unit);
+		if (num > 0)
+			s_level = MIN(FIXED_Divide(num, &sUnitDiv), 9u);
+	}
+	uint8_t overS9dBm = FIXED_Saturate(rssi_dBm + gEeprom.S9_LEVEL, 0, 99);
+	uint8_t overS9Bars = MIN(FIXED_Divide(overS9dBm, &tenDiv), 4u);
 
 	if(overS9Bars == 0) {
-		sprintf(str, "% 4d S%d", rssi_dBm, s_level);
+		FORMAT_SMeter(str, rssi_dBm, s_level, 0);
 	}
 	else {
-		sprintf(str, "% 4d  %2d", rssi_dBm, overS9dBm);
+		FORMAT_SMeter(str, rssi_dBm, s_level, overS9dBm);
 		memcpy(p_line + 2 + 7*5, &plus, ARRAY_SIZE(plus));
 	}
 
@@ -222,7 +238,7 @@ void DisplayRSSIBar(const bool now)
 	if (now)
 		ST7565_BlitLine(line);
 #else
-	int16_t rssi = BK4819_GetRSSI();
+	int16_t rssi = RSSI_GetAverage();
 	uint8_t Level;
 
 	if (rssi >= gEEPROM_RSSI_CALIB[gRxVfo->Band][3]) {
@@ -342,9 +358,9 @@ void UI_DisplayMain(void)
 #ifdef ENABLE_SCAN_RANGES
 			if(gScanRangeStart) {
 				UI_PrintString("ScnRng", 5, 0, line, 8);
-				sprintf(String, "%3u.%05u", gScanRangeStart / 100000, gScanRangeStart % 100000);
+				FORMAT_Frequency(String, gScanRangeStart, 5, 3, ' ');
 				UI_PrintStringSmallNormal(String, 56, 0, line);
-				sprintf(String, "%3u.%05u", gScanRangeStop / 100000, gScanRangeStop % 100000);
+				FORMAT_Frequency(String, gScanRangeStop, 5, 3, ' ');
 				UI_PrintStringSmallNormal(String, 56, 0, line + 1);
 				continue;
 			}
@@ -437,7 +453,7 @@ void UI_DisplayMain(void)
 			const unsigned int x = 2;
 			const bool inputting = gInputBoxIndex != 0 && gEeprom.TX_VFO == vfo_num;
 			if (!inputting)
-				sprintf(String, "M%u", gEeprom.ScreenChannel[vfo_num] + 1);
+				FORMAT_Channel(String, "M", gEeprom.ScreenChannel[vfo_num] + 1, 0);
 			else
 				sprintf(String, "M%.3s", INPUTBOX_GetAscii());  // show the input text
 			UI_PrintStringSmallNormal(String, x, 0, line + 1);
@@ -455,7 +471,7 @@ void UI_DisplayMain(void)
 		{
 			if (gInputBoxIndex == 0 || gEeprom.TX_VFO != vfo_num)
 			{	// channel number
-				sprintf(String, "N%u", 1 + gEeprom.ScreenChannel[vfo_num] - NOAA_CHANNEL_FIRST);
+				FORMAT_Channel(String, "N", 1 + gEeprom.ScreenChannel[vfo_num] - NOAA_CHANNEL_FIRST, 0);
 			}
 			else
 			{	// user entering channel number
@@ -534,7 +550,7 @@ void UI_DisplayMain(void)
 				switch (gEeprom.CHANNEL_DISPLAY_MODE)
 				{
 					case MDF_FREQUENCY:	// show the channel frequency
-						sprintf(String, "%3u.%05u", frequency / 100000, frequency % 100000);
+						FORMAT_Frequency(String, frequency, 5, 3, ' ');
 #ifdef ENABLE_BIG_FREQ
 						if(frequency < _1GHz_in_KHz) {
 							// show the remaining 2 small frequency digits
@@ -553,7 +569,7 @@ void UI_DisplayMain(void)
 						break;
 
 					case MDF_CHANNEL:	// show the channel number
-						sprintf(String, "CH-%03u", gEeprom.ScreenChannel[vfo_num] + 1);
+						FORMAT_Channel(String, "CH-", gEeprom.ScreenChannel[vfo_num] + 1, 3);
 						UI_PrintString(String, 32, 0, line, 8);
 						break;
 
@@ -563,7 +579,7 @@ void UI_DisplayMain(void)
 						SETTINGS_FetchChannelName(String, gEeprom.ScreenChannel[vfo_num]);
 						if (String[0] == 0)
 						{	// no channel name, show the channel number instead
-							sprintf(String, "CH-%03u", gEeprom.ScreenChannel[vfo_num] + 1);
+							FORMAT_Channel(String, "CH-", gEeprom.ScreenChannel[vfo_num] + 1, 3);
 						}
 
 						if (gEeprom.CHANNEL_DISPLAY_MODE == MDF_NAME) {
@@ -572,7 +588,7 @@ void UI_DisplayMain(void)
 						else {
 							UI_PrintStringSmallBold(String, 32 + 4, 0, line);
 							// show the channel frequency below the channel number/name
-							sprintf(String, "%03u.%05u", frequency / 100000, frequency % 100000);
+							FORMAT_Frequency(String, frequency, 5, 3, '0');
 							UI_PrintStringSmallNormal(String, 32 + 4, 0, line + 1);
 						}
 
@@ -581,7 +597,7 @@ void UI_DisplayMain(void)
 			}
 			else
 			{	// frequency mode
-				sprintf(String, "%3u.%05u", frequency / 100000, frequency % 100000);
+				FORMAT_Frequency(String, frequency, 5, 3, ' ');
 
 #ifdef ENABLE_BIG_FREQ
 				if(frequency < _1GHz_in_KHz) {
@@ -657,16 +673,31 @@ void UI_DisplayMain(void)
 				s = gModulationStr[mod];
 			break;
 		}
+
+#ifdef ENABLE_CSS_DECODE
+		// the tone/code heard on a carrier squelch channel takes the power and offset slots
+		const bool css_decoded = mode == VFO_MODE_RX && FUNCTION_IsRx() && gEeprom.RX_VFO == vfo_num &&
+		                         gRxCssDecodeType != CODE_TYPE_OFF;
+		if (css_decoded) {
+			if (gRxCssDecodeType == CODE_TYPE_CONTINUOUS_TONE)
+				FORMAT_Decimal(String, CTCSS_Options[gRxCssDecodeCode], 1, 1, 0, ' ');
+			else
+				FORMAT_DcsCode(String, DCS_Options[gRxCssDecodeCode], gRxCssDecodeType != CODE_TYPE_DIGITAL);
+			s = String;
+		}
+#else
+		const bool css_decoded = false;
+#endif
 		UI_PrintStringSmallNormal(s, LCD_WIDTH + 24, 0, line + 1);
 
-		if (state == VFO_STATE_NORMAL || state == VFO_STATE_ALARM)
+		if ((state == VFO_STATE_NORMAL || state == VFO_STATE_ALARM) && !css_decoded)
 		{	// show the TX power
 			const char pwr_list[][2] = {"L","M","H"};
 			int i = vfoInfo->OUTPUT_POWER % 3;
 			UI_PrintStringSmallNormal(pwr_list[i], LCD_WIDTH + 46, 0, line + 1);
 		}
 
-		if (vfoInfo->freq_config_RX.Frequency != vfoInfo->freq_config_TX.Frequency)
+		if (vfoInfo->freq_config_RX.Frequency != vfoInfo->freq_config_TX.Frequency && !css_decoded)
 		{	// show the TX offset symbol
 			const char dir_list[][2] = {"", "+", "-"};
 			int i = vfoInfo->TX_OFFSET_FREQUENCY_DIRECTION % 3;
@@ -735,40 +766,21 @@ void UI_DisplayMain(void)
 #endif
 		if (rx || gCurrentFunction == FUNCTION_FOREGROUND || gCurrentFunction == FUNCTION_POWER_SAVE)
 		{
-			#if 1
-				if (gSetting_live_DTMF_decoder && gDTMF_RX_live[0] != 0)
-				{	// show live DTMF decode
-					const unsigned int len = strlen(gDTMF_RX_live);
-					const unsigned int idx = (len > (17 - 5)) ? len - (17 - 5) : 0;  // limit to last 'n' chars
-
-					if (gScreenToDisplay != DISPLAY_MAIN
+			if (gSetting_live_DTMF_decoder && gDTMF_RX_live.Count > 0)
+			{	// show live DTMF decode
+				if (gScreenToDisplay != DISPLAY_MAIN
 #ifdef ENABLE_DTMF_CALLING
-						|| gDTMF_CallState != DTMF_CALL_STATE_NONE
+					|| gDTMF_CallState != DTMF_CALL_STATE_NONE
 #endif
-						)
-						return;
-
-					center_line = CENTER_LINE_DTMF_DEC;
-
-					sprintf(String, "DTMF %s", gDTMF_RX_live + idx);
-					UI_PrintStringSmallNormal(String, 2, 0, 3);
-				}
-			#else
-				if (gSetting_live_DTMF_decoder && gDTMF_RX_index > 0)
-				{	// show live DTMF decode
-					const unsigned int len = gDTMF_RX_index;
-					const unsigned int idx = (len > (17 - 5)) ? len - (17 - 5) : 0;  // limit to last 'n' chars
-
-					if (gScreenToDisplay != DISPLAY_MAIN ||
-						gDTMF_CallState != DTMF_CALL_STATE_NONE)
-						return;
+					)
+					return;
 
-					center_line = CENTER_LINE_DTMF_DEC;
+				center_line = CENTER_LINE_DTMF_DEC;
 
-					sprintf(String, "DTMF %s", gDTMF_RX_live + idx);
-					UI_PrintStringSmallNormal(String, 2, 0, 3);
-				}
-			#endif
+				strcpy(String, "DTMF ");
+				DTMF_RingCopy(&gDTMF_RX_live, String + 5, 17 - 5);  // limit to last 'n' chars
+				UI_PrintStringSmallNormal(String, 2, 0, 3);
+			}
 
 #ifdef ENABLE_SHOW_CHARGE_LEVEL
 			else if (gChargingWithTypeC)
@@ -782,9 +794,11 @@ void UI_DisplayMain(void)
 
 				center_line = CENTER_LINE_CHARGE_DATA;
 
-				sprintf(String, "Charge %u.%02uV %u%%",
-					gBatteryVoltageAverage / 100, gBatteryVoltageAverage % 100,
-					BATTERY_VoltsToPercent(gBatteryVoltageAverage));
+				strcpy(String, "Charge ");
+				char *p = FORMAT_Decimal(String + 7, gBatteryVoltageAverage, 2, 2, 0, ' ');
+				*p++ = 'V';
+				*p++ = ' ';
+				FORMAT_Percent(p, BATTERY_VoltsToPercent(gBatteryVoltageAverage));
 				UI_PrintStringSmallNormal(String, 2, 0, 3);
 			}
 #endif
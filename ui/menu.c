@@ -29,6 +29,7 @@
 #include "../external/printf/printf.h"
 #include "../frequencies.h"
 #include "../helper/battery.h"
+#include "../helper/format.h"
 #include "../misc.h"
 #include "../settings.h"
 #include "helper.h"
@@ -363,7 +364,10 @@ const t_sidefunction gSubMenu_SIDEFUNCTIONS[] =
 	{"BLMIN\nTMP OFF",  ACTION_OPT_BLMIN_TMP_OFF}, 		//BackLight Minimum Temporay OFF
 #endif
 #ifdef ENABLE_SPECTRUM
-	{"SPECTRUM",         ACTION_OPT_SPECTRUM}
+	{"SPECTRUM",         ACTION_OPT_SPECTRUM},
+#endif
+#ifdef ENABLE_CHANNEL_STATS
+	{"CHANNEL\nSTATS",	ACTION_OPT_CHSTATS},
 #endif
 };
 
@@ -511,7 +515,7 @@ void UI_DisplayMenu(void)
 
 		case MENU_STEP: {
 			uint16_t step = gStepFrequencyTable[FREQUENCY_GetStepIdxFromSortedIdx(gSubMenuSelection)];
-			sprintf(String, "%d.%02ukHz", step / 100, step % 100);
+			strcpy(FORMAT_Decimal(String, step, 2, 2, 0, ' '), "kHz");
 			break;
 		}
 
@@ -648,7 +652,7 @@ void UI_DisplayMenu(void)
 			if (valid && !gAskForConfirmation)
 			{	// show the frequency so that the user knows the channels frequency
 				const uint32_t frequency = SETTINGS_FetchChannelFrequency(gSubMenuSelection);
-				sprintf(String, "%u.%05u", frequency / 100000, frequency % 100000);
+				FORMAT_Frequency(String, frequency, 5, 0, ' ');
 				UI_PrintString(String, menu_item_x1, menu_item_x2, 4, 8);
 			}
 
@@ -684,7 +688,7 @@ void UI_DisplayMenu(void)
 
 				if (!gAskForConfirmation)
 				{	// show the frequency so that the user knows the channels frequency
-					sprintf(String, "%u.%05u", frequency / 100000, frequency % 100000);
+					FORMAT_Frequency(String, frequency, 5, 0, ' ');
 					UI_PrintString(String, menu_item_x1, menu_item_x2, 4 + (gIsInSubMenu && edit_index >= 0), 8);
 				}
 			}
@@ -792,10 +796,13 @@ void UI_DisplayMenu(void)
 			break;
 
 		case MENU_VOL:
-			sprintf(String, "%u.%02uV\n%u%%",
-				gBatteryVoltageAverage / 100, gBatteryVoltageAverage % 100,
-				BATTERY_VoltsToPercent(gBatteryVoltageAverage));
+		{
+			char *p = FORMAT_Decimal(String, gBatteryVoltageAverage, 2, 2, 0, ' ');
+			*p++ = 'V';
+			*p++ = '\n';
+			FORMAT_Percent(p, BATTERY_VoltsToPercent(gBatteryVoltageAverage));
 			break;
+		}
 
 		case MENU_RESET:
 			strcpy(String, gSubMenu_RESET[gSubMenuSelection]);
@@ -23,10 +23,16 @@
 	#include "app/fm.h"
 #endif
 #include "driver/keyboard.h"
+#ifdef ENABLE_PROFILING
+	#include "helper/profile.h"
+#endif
 #include "misc.h"
 #ifdef ENABLE_AIRCOPY
 	#include "ui/aircopy.h"
 #endif
+#ifdef ENABLE_CHANNEL_STATS
+	#include "ui/chstats.h"
+#endif
 #ifdef ENABLE_FMRADIO
 	#include "ui/fmradio.h"
 #endif
@@ -57,6 +63,10 @@ void (*UI_DisplayFunctions[])(void) = {
 #ifdef ENABLE_AIRCOPY
 	[DISPLAY_AIRCOPY] = &UI_DisplayAircopy,
 #endif
+
+#ifdef ENABLE_CHANNEL_STATS
+	[DISPLAY_CHSTATS] = &UI_DisplayChannelStats,
+#endif
 };
 
 static_assert(ARRAY_SIZE(UI_DisplayFunctions) == DISPLAY_N_ELEM);
@@ -64,7 +74,16 @@ static_assert(ARRAY_SIZE(UI_DisplayFunctions) == DISPLAY_N_ELEM);
 void GUI_DisplayScreen(void)
 {
 	if (gScreenToDisplay != DISPLAY_INVALID) {
+#ifdef ENABLE_PROFILING
+		const uint32_t start_us = PROFILE_GetTimeUs();
+		UI_DisplayFunctions[gScreenToDisplay]();
+		if (gScreenToDisplay == DISPLAY_MAIN)
+			gProfileCounters[PROFILE_DISPLAY_MAIN_US] = PROFILE_GetTimeUs() - start_us;
+		else if (gScreenToDisplay == DISPLAY_MENU)
+			gProfileCounters[PROFILE_DISPLAY_MENU_US] = PROFILE_GetTimeUs() - start_us;
+#else
 		UI_DisplayFunctions[gScreenToDisplay]();
+#endif
 	}
 }
 